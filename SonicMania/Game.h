@@ -41,7 +41,7 @@
 #endif
 
 #ifndef RETRO_MOD_LOADER_VER
-#define RETRO_MOD_LOADER_VER (2)
+#define RETRO_MOD_LOADER_VER (3)
 #endif
 
 // -------------------------
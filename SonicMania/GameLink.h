@@ -1303,6 +1303,32 @@ typedef struct {
     void (*CopyCollisionMask)(uint16 dst, uint16 src, uint8 cPlane, uint8 cMode);
     void (*GetCollisionInfo)(CollisionMask **masks, TileInfo **tileInfo);
 #endif
+
+#if RETRO_MOD_LOADER_VER >= 3
+    // Scenes
+    // starts loading the scene at 'listPos' (in the active category) in the background, call it while the current scene's winding down
+    bool32 (*PreloadScene)(int32 listPos);
+
+    // Objects/Entities
+    // GetActiveEntities, but only entities whose position +/- updateRange overlaps the given box (world space, fixed point)
+    bool32 (*GetActiveEntitiesInBounds)(uint16 group, void **entity, int32 left, int32 top, int32 right, int32 bottom);
+    // gives a class update/lateUpdate callbacks that get passed the entity & only touch that entity, which lets them be run in parallel
+    // NULL keeps that callback serial, the class' regular callbacks are still used while paused or frozen
+    bool32 (*SetIsolatedUpdate)(const char *name, void (*update)(void *entity), void (*lateUpdate)(void *entity));
+
+    // Collision
+    // CheckObjectCollisionTouchBox against up to 32 entity/hitbox pairs at once, bit N of the result is set if pair N collided
+    uint32 (*CheckObjectCollisionTouchBatch)(void *thisEntity, Hitbox *thisHitbox, void **otherEntities, Hitbox **otherHitboxes, int32 count);
+
+    // Snapshots
+    // snapshots the scene's state (entities, statics, globals, tiles, palettes, cameras, timer & rng), returns its ID or -1
+    int32 (*CaptureSnapshot)(void);
+    // rolls the scene back to a snapshot from the ring & drops any newer ones, call it outside of entity updates
+    bool32 (*RestoreSnapshot)(int32 id);
+    // the IDs still in the ring, both are -1 if it's empty
+    void (*GetSnapshotRange)(int32 *oldest, int32 *newest);
+    void (*ClearSnapshots)(void);
+#endif
 } ModFunctionTable;
 #endif
 
@@ -1713,6 +1739,12 @@ typedef struct {
     void (*NotifyCallback)(int32 callbackID, int32 param1, int32 param2, int32 param3);
     void (*SetGameFinished)(void);
 #endif
+
+#if RETRO_USE_MOD_LOADER && RETRO_MOD_LOADER_VER >= 3
+    // Math (Batched), these are only in this engine's table, older engines stop before them
+    void (*RotatePoints)(Vector2 *points, int32 count, Vector2 *origin, int32 angle);
+    void (*ATan2Batch)(const Vector2 *vectors, uint8 *angles, int32 count);
+#endif
 } RSDKFunctionTable;
 
 // -------------------------
@@ -1914,6 +1946,15 @@ typedef struct {
     Entity *entityOut = NULL;                                                                                                                        \
     while (RSDK.GetAllEntities(type, (void **)&entityOut))
 
+// foreach_active, minus the entities whose updateRange doesn't reach the given box, without the mod loader it's just foreach_active
+#if RETRO_USE_MOD_LOADER && RETRO_MOD_LOADER_VER >= 3
+#define foreach_active_bounds(type, entityOut, left, top, right, bottom)                                                                             \
+    Entity##type *entityOut = NULL;                                                                                                                  \
+    while (Mod.GetActiveEntitiesInBounds(type->classID, (void **)&entityOut, left, top, right, bottom))
+#else
+#define foreach_active_bounds(type, entityOut, left, top, right, bottom) foreach_active(type, entityOut)
+#endif
+
 #if RETRO_USE_MOD_LOADER
 
 #if RETRO_MOD_LOADER_VER >= 2
@@ -663,6 +663,12 @@ void ActClear_State_ScoreShownDelay(void)
 {
     RSDK_THIS(ActClear);
 
+#if RETRO_USE_MOD_LOADER && RETRO_MOD_LOADER_VER >= 3
+    // ActClear_State_SaveGameProgress moves on to the next scene in the list, so get it loading while the tally plays out
+    if (!self->timer && ActClear->displayedActID <= 0 && globals->gameMode != MODE_COMPETITION && globals->gameMode != MODE_TIMEATTACK)
+        Mod.PreloadScene(SceneInfo->listPos + 1);
+#endif
+
     if (++self->timer == 120) {
         self->timer = 0;
         self->state = ActClear_State_TallyScore;
@@ -1131,7 +1131,11 @@ void ItemBox_HandleObjectCollisions(void)
         }
     }
 
-    foreach_active(Spikes, spikes)
+    int32 left   = self->position.x + (ItemBox->hitboxItemBox.left << 16);
+    int32 top    = self->position.y + (ItemBox->hitboxItemBox.top << 16);
+    int32 right  = self->position.x + (ItemBox->hitboxItemBox.right << 16);
+    int32 bottom = self->position.y + (ItemBox->hitboxItemBox.bottom << 16);
+    foreach_active_bounds(Spikes, spikes, left, top, right, bottom)
     {
         int32 storeX = spikes->position.x;
         int32 storeY = spikes->position.y;
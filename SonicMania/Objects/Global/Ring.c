@@ -453,7 +453,14 @@ void Ring_CheckObjectCollisions(int32 x, int32 y)
     }
 
     if (Spikes) {
-        foreach_active(Spikes, spikes) { collisionSides |= 1 << RSDK.CheckObjectCollisionBox(spikes, &spikes->hitbox, self, &Ring->hitbox, true); }
+        int32 left   = self->position.x + (Ring->hitbox.left << 16);
+        int32 top    = self->position.y + (Ring->hitbox.top << 16);
+        int32 right  = self->position.x + (Ring->hitbox.right << 16);
+        int32 bottom = self->position.y + (Ring->hitbox.bottom << 16);
+        foreach_active_bounds(Spikes, spikes, left, top, right, bottom)
+        {
+            collisionSides |= 1 << RSDK.CheckObjectCollisionBox(spikes, &spikes->hitbox, self, &Ring->hitbox, true);
+        }
     }
 
     if (Ice) {
@@ -17,12 +17,38 @@ stb_vorbis_alloc vorbisAlloc;
 SFXInfo RSDK::sfxList[SFX_COUNT];
 ChannelInfo RSDK::channels[CHANNEL_COUNT];
 
+#if !RETRO_USE_ORIGINAL_CODE
+#if RETRO_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+SFXCacheEntry RSDK::sfxCache[SFXCACHE_COUNT];
+uint32 sfxCacheTick = 0;
+
+HashIndexMD5<SFX_COUNT * 2> RSDK::sfxIndex;
+#endif
+
 char streamFilePath[0x40];
 uint8 *streamBuffer    = NULL;
 int32 streamBufferSize = 0;
 uint32 streamStartPos  = 0;
 int32 streamLoopPoint  = 0;
 
+#if !RETRO_USE_ORIGINAL_CODE
+// Maps the sample position at the end of each ogg page to the page's offset, built once when a stream is opened
+// If a track has more pages than will fit, only every `streamSeekIndexStride`th page is stored
+#define STREAM_SEEKINDEX_COUNT (0x1000)
+
+struct StreamSeekEntry {
+    uint32 pageStart;
+    uint32 lastSample;
+};
+
+StreamSeekEntry streamSeekIndex[STREAM_SEEKINDEX_COUNT];
+int32 streamSeekIndexCount  = 0;
+int32 streamSeekIndexStride = 1;
+#endif
+
 #define LINEAR_INTERPOLATION_LOOKUP_DIVISOR 0x40 // Determines the 'resolution' of the lookup table.
 #define LINEAR_INTERPOLATION_LOOKUP_LENGTH  (TO_FIXED(1) / LINEAR_INTERPOLATION_LOOKUP_DIVISOR)
 
@@ -172,7 +198,12 @@ void AudioDeviceBase::InitAudioChannels()
     // to speed-up the process of converting from fixed-point to floating-point.
     for (int32 i = 0; i < LINEAR_INTERPOLATION_LOOKUP_LENGTH; ++i) linearInterpolationLookup[i] = i / (float)LINEAR_INTERPOLATION_LOOKUP_LENGTH;
 
+#if !RETRO_USE_ORIGINAL_CODE
+    GEN_HASH_MD5_CONST("Stream Channel 0", sfxList[SFX_COUNT - 1].hash);
+    sfxIndex.Invalidate();
+#else
     GEN_HASH_MD5("Stream Channel 0", sfxList[SFX_COUNT - 1].hash);
+#endif
     sfxList[SFX_COUNT - 1].scope              = SCOPE_GLOBAL;
     sfxList[SFX_COUNT - 1].maxConcurrentPlays = 1;
     sfxList[SFX_COUNT - 1].length             = MIX_BUFFER_SIZE;
@@ -181,6 +212,216 @@ void AudioDeviceBase::InitAudioChannels()
     initializedAudioChannels = true;
 }
 
+#if !RETRO_USE_ORIGINAL_CODE
+// the same as stb_vorbis' get_seek_page_info, but reads straight from the stream's memory
+bool32 GetStreamPageInfo(stb_vorbis *f, uint32 pageStart, uint32 *pageEnd, uint32 *lastSample)
+{
+    uint32 size = (uint32)(f->stream_end - f->stream_start);
+    if (pageStart + 27 > size)
+        return false;
+
+    uint8 *header = &f->stream_start[pageStart];
+    if (header[0] != 'O' || header[1] != 'g' || header[2] != 'g' || header[3] != 'S' || pageStart + 27 + header[26] > size)
+        return false;
+
+    uint32 length = 0;
+    for (int32 s = 0; s < header[26]; ++s) length += header[27 + s];
+
+    *pageEnd    = pageStart + 27 + header[26] + length;
+    *lastSample = header[6] | (header[7] << 8) | (header[8] << 16) | ((uint32)header[9] << 24);
+    return true;
+}
+
+void BuildStreamSeekIndex(stb_vorbis *f)
+{
+    streamSeekIndexCount  = 0;
+    streamSeekIndexStride = 1;
+
+    // this also locates the last page (f->p_last), which the seek code needs
+    if (!stb_vorbis_stream_length_in_samples(f))
+        return;
+
+    uint32 pageStart  = f->p_first.page_start;
+    uint32 pageEnd    = 0;
+    uint32 lastSample = 0;
+    int32 pageID      = 0;
+    while (pageStart < f->p_last.page_start && GetStreamPageInfo(f, pageStart, &pageEnd, &lastSample)) {
+        // pages where no packet ends can't be seeked to, so they're skipped like stb_vorbis does
+        if (lastSample != ~0U) {
+            if (streamSeekIndexCount == STREAM_SEEKINDEX_COUNT) {
+                for (int32 i = 0; i < STREAM_SEEKINDEX_COUNT / 2; ++i) streamSeekIndex[i] = streamSeekIndex[i * 2];
+
+                streamSeekIndexCount = STREAM_SEEKINDEX_COUNT / 2;
+                streamSeekIndexStride *= 2;
+            }
+
+            if (!(pageID++ % streamSeekIndexStride)) {
+                streamSeekIndex[streamSeekIndexCount].pageStart  = pageStart;
+                streamSeekIndex[streamSeekIndexCount].lastSample = lastSample;
+                ++streamSeekIndexCount;
+            }
+        }
+
+        pageStart = pageEnd;
+    }
+
+    // if the pages don't chain together cleanly (garbage between pages, truncated file, etc) let stb_vorbis deal with seeking instead
+    if (pageStart != f->p_last.page_start)
+        streamSeekIndexCount = 0;
+}
+
+// Replacement for stb_vorbis' seek_to_sample_coarse that looks up the starting page in streamSeekIndex instead of bisecting the file.
+// It always picks the same page the bisection would've, so the decoder ends up in the exact same state.
+int32 SeekStreamCoarse(stb_vorbis *f, uint32 sampleNumber)
+{
+    uint32 streamLength = stb_vorbis_stream_length_in_samples(f);
+    if (!streamLength)
+        return error(f, VORBIS_seek_without_length);
+    if (sampleNumber > streamLength)
+        return error(f, VORBIS_seek_invalid);
+
+    uint32 padding         = (f->blocksize_1 - f->blocksize_0) >> 2;
+    uint32 lastSampleLimit = sampleNumber < padding ? 0 : sampleNumber - padding;
+
+    if (lastSampleLimit <= streamSeekIndex[0].lastSample) {
+        if (stb_vorbis_seek_start(f)) {
+            if (f->current_loc > sampleNumber)
+                return error(f, VORBIS_seek_failed);
+            return true;
+        }
+        return false;
+    }
+
+    // find the last indexed page that ends before the limit...
+    int32 lo = 0;
+    int32 hi = streamSeekIndexCount - 1;
+    while (lo < hi) {
+        int32 mid = (lo + hi + 1) >> 1;
+        if (streamSeekIndex[mid].lastSample <= lastSampleLimit)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+
+    // ...then walk over any pages the index skipped
+    uint32 pageStart  = streamSeekIndex[lo].pageStart;
+    uint32 pageEnd    = 0;
+    uint32 lastSample = 0;
+    GetStreamPageInfo(f, pageStart, &pageEnd, &lastSample);
+
+    uint32 nextPage = pageEnd;
+    while (nextPage < f->p_last.page_start && GetStreamPageInfo(f, nextPage, &pageEnd, &lastSample)) {
+        if (lastSample != ~0U) {
+            if (lastSample > lastSampleLimit)
+                break;
+
+            pageStart = nextPage;
+        }
+
+        nextPage = pageEnd;
+    }
+
+    // everything from here on matches seek_to_sample_coarse
+    set_file_offset(f, pageStart);
+    if (!start_page(f))
+        return error(f, VORBIS_seek_failed);
+    int32 endPos = f->end_seg_with_known_loc;
+
+    int32 startSeg = 0;
+    for (;;) {
+        for (startSeg = endPos; startSeg > 0; --startSeg)
+            if (f->segments[startSeg - 1] != 255)
+                break;
+
+        if (startSeg > 0 || !(f->page_flag & PAGEFLAG_continued_packet))
+            break;
+
+        // the final packet begins on an earlier page
+        if (!go_to_page_before(f, pageStart)) {
+            stb_vorbis_seek_start(f);
+            return error(f, VORBIS_seek_failed);
+        }
+
+        pageStart = stb_vorbis_get_file_offset(f);
+        if (!start_page(f)) {
+            stb_vorbis_seek_start(f);
+            return error(f, VORBIS_seek_failed);
+        }
+        endPos = f->segment_count - 1;
+    }
+
+    f->current_loc_valid = false;
+    f->last_seg          = false;
+    f->valid_bits        = 0;
+    f->packet_bytes      = 0;
+    f->bytes_in_seg      = 0;
+    f->previous_length   = 0;
+    f->next_seg          = startSeg;
+
+    for (int32 i = 0; i < startSeg; ++i) skip(f, f->segments[i]);
+
+    if (!vorbis_pump_first_frame(f))
+        return false;
+    if (f->current_loc > sampleNumber)
+        return error(f, VORBIS_seek_failed);
+    return true;
+}
+
+// stb_vorbis_seek_frame, using the seek index when there is one
+int32 SeekStreamFrame(stb_vorbis *f, uint32 sampleNumber)
+{
+    if (!streamSeekIndexCount)
+        return stb_vorbis_seek_frame(f, sampleNumber);
+
+    if (!SeekStreamCoarse(f, sampleNumber))
+        return false;
+
+    // linear search for the relevant packet
+    uint32 maxFrameSamples = (f->blocksize_1 * 3 - f->blocksize_0) >> 2;
+    while (f->current_loc < sampleNumber) {
+        int32 leftStart, leftEnd, rightStart, rightEnd, mode;
+        if (!peek_decode_initial(f, &leftStart, &leftEnd, &rightStart, &rightEnd, &mode))
+            return error(f, VORBIS_seek_failed);
+
+        int32 frameSamples = rightStart - leftStart;
+        if (f->current_loc + frameSamples > sampleNumber) {
+            return true; // the next frame will contain the sample
+        }
+        else if (f->current_loc + frameSamples + maxFrameSamples > sampleNumber) {
+            // there's a chance the frame after this could contain the sample
+            vorbis_pump_first_frame(f);
+        }
+        else {
+            // this frame is too early to be relevant
+            f->current_loc += frameSamples;
+            f->previous_length = 0;
+            maybe_start_packet(f);
+            flush_packet(f);
+        }
+    }
+
+    if (f->current_loc != sampleNumber)
+        return error(f, VORBIS_seek_failed);
+    return true;
+}
+
+// stb_vorbis_seek, using the seek index when there is one
+int32 SeekStream(stb_vorbis *f, uint32 sampleNumber)
+{
+    if (!SeekStreamFrame(f, sampleNumber))
+        return false;
+
+    if (sampleNumber != f->current_loc) {
+        int32 n;
+        uint32 frameStart = f->current_loc;
+        stb_vorbis_get_frame_float(f, &n, NULL);
+        f->channel_buffer_start += (sampleNumber - frameStart);
+    }
+
+    return true;
+}
+#endif
+
 void RSDK::UpdateStreamBuffer(ChannelInfo *channel)
 {
     int32 bufferRemaining = MIX_BUFFER_SIZE;
@@ -189,7 +430,19 @@ void RSDK::UpdateStreamBuffer(ChannelInfo *channel)
     for (int32 s = 0; s < MIX_BUFFER_SIZE;) {
         int32 samples = stb_vorbis_get_samples_float_interleaved(vorbisInfo, 2, buffer, bufferRemaining) * 2;
         if (!samples) {
+#if !RETRO_USE_ORIGINAL_CODE
+            bool32 looped = false;
+            if (channel->loop == 1) {
+                // this runs on the audio thread, so the time goes through the profiler's thread-safe path
+                uint64 seekTicks = GetProfilerTicks();
+                looped           = SeekStreamFrame(vorbisInfo, streamLoopPoint);
+                AddProfileTicksAsync(PROFILE_STREAM_SEEK, GetProfilerTicks() - seekTicks);
+            }
+
+            if (looped) {
+#else
             if (channel->loop == 1 && stb_vorbis_seek_frame(vorbisInfo, streamLoopPoint)) {
+#endif
                 // we're looping & the seek was successful, get more samples
             }
             else {
@@ -232,8 +485,18 @@ void RSDK::LoadStream(ChannelInfo *channel)
 
             vorbisInfo = stb_vorbis_open_memory(streamBuffer, streamBufferSize, NULL, &vorbisAlloc);
             if (vorbisInfo) {
+#if !RETRO_USE_ORIGINAL_CODE
+                BuildStreamSeekIndex(vorbisInfo);
+
+                if (streamStartPos) {
+                    uint64 seekTicks = GetProfilerTicks();
+                    SeekStream(vorbisInfo, streamStartPos);
+                    AddProfileTicksAsync(PROFILE_STREAM_SEEK, GetProfilerTicks() - seekTicks);
+                }
+#else
                 if (streamStartPos)
                     stb_vorbis_seek(vorbisInfo, streamStartPos);
+#endif
                 UpdateStreamBuffer(channel);
 
                 channel->state = CHANNEL_STREAM;
@@ -302,6 +565,140 @@ int32 RSDK::PlayStream(const char *filename, uint32 slot, uint32 startPos, uint3
 #define WAV_SIG_HEADER (0x46464952) // RIFF
 #define WAV_SIG_DATA   (0x61746164) // data
 
+#if !RETRO_USE_ORIGINAL_CODE
+// Converts `count` WAV samples to F32. `samples` is allowed to point into the back end of `buffer` (see LoadSfxToSlot),
+// this is safe as long as samples are processed front to back & each block is fully read before it's written back out.
+void ConvertSfxSamples(float *buffer, const uint8 *samples, uint32 count, uint16 sampleBits)
+{
+    uint32 s = 0;
+
+    if (sampleBits == 8) {
+        // 8-bit sample. Convert from U8 to S8, and then from S8 to F32.
+#if RETRO_USE_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i bias = _mm_set1_epi32(0x80);
+        const __m128 scale = _mm_set1_ps(1.0f / 0x80);
+        for (; s + 8 <= count; s += 8) {
+            __m128i block = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)&samples[s]), zero);
+            __m128i lo    = _mm_sub_epi32(_mm_unpacklo_epi16(block, zero), bias);
+            __m128i hi    = _mm_sub_epi32(_mm_unpackhi_epi16(block, zero), bias);
+
+            _mm_storeu_ps(&buffer[s + 0], _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+            _mm_storeu_ps(&buffer[s + 4], _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+        }
+#endif
+
+        for (; s < count; ++s) buffer[s] = (samples[s] - 0x80) * (1.0f / 0x80);
+    }
+    else {
+        // 16-bit sample. Convert from S16 (always little-endian) to F32.
+        // (x / 0x8000) * 0.75 and x * (0.75 / 0x8000) are both exact for every S16 value, so this matches the original conversion
+#if RETRO_USE_SSE2
+        const __m128 scale = _mm_set1_ps(0.75f / 0x8000);
+        for (; s + 8 <= count; s += 8) {
+            __m128i block = _mm_loadu_si128((const __m128i *)&samples[s * sizeof(int16)]);
+            __m128i lo    = _mm_srai_epi32(_mm_unpacklo_epi16(block, block), 16);
+            __m128i hi    = _mm_srai_epi32(_mm_unpackhi_epi16(block, block), 16);
+
+            _mm_storeu_ps(&buffer[s + 0], _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+            _mm_storeu_ps(&buffer[s + 4], _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+        }
+#endif
+
+        for (; s < count; ++s) {
+            const uint8 *sample = &samples[s * sizeof(int16)];
+            buffer[s]           = (int16)(sample[0] | (sample[1] << 8)) * (0.75f / 0x8000);
+        }
+    }
+}
+
+bool32 LoadSfxFromCache(uint32 *hash, uint8 slot)
+{
+    for (int32 c = 0; c < SFXCACHE_COUNT; ++c) {
+        SFXCacheEntry *entry = &sfxCache[c];
+
+        if (entry->buffer && HASH_MATCH_MD5(entry->hash, hash)) {
+            // share the cached buffer, the extra storage entry keeps it alive for as long as the slot uses it
+            CopyStorage((uint32 **)&sfxList[slot].buffer, (uint32 **)&entry->buffer);
+            sfxList[slot].length = entry->length;
+            entry->lastUsed      = ++sfxCacheTick;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void AddSfxToCache(uint32 *hash, uint8 slot)
+{
+    size_t size = sfxList[slot].length * sizeof(float);
+    if (!sfxList[slot].buffer || size > SFXCACHE_SIZE)
+        return;
+
+    // evict the least recently used sfx until there's a free entry & enough room in the budget
+    SFXCacheEntry *entry = NULL;
+    while (true) {
+        SFXCacheEntry *oldest = NULL;
+        size_t cacheSize      = 0;
+
+        entry = NULL;
+        for (int32 c = 0; c < SFXCACHE_COUNT; ++c) {
+            SFXCacheEntry *cached = &sfxCache[c];
+
+            if (!cached->buffer) {
+                if (!entry)
+                    entry = cached;
+            }
+            else {
+                cacheSize += cached->length * sizeof(float);
+                if (!oldest || cached->lastUsed < oldest->lastUsed)
+                    oldest = cached;
+            }
+        }
+
+        if (entry && cacheSize + size <= SFXCACHE_SIZE)
+            break;
+
+        if (!oldest)
+            return;
+
+        // nulling the entry's pointer is enough, the storage GC will free the buffer once no sfx slot uses it anymore
+        MEM_ZERO(*oldest);
+    }
+
+    HASH_COPY_MD5(entry->hash, hash);
+    CopyStorage((uint32 **)&entry->buffer, (uint32 **)&sfxList[slot].buffer);
+    entry->length   = sfxList[slot].length;
+    entry->lastUsed = ++sfxCacheTick;
+}
+
+void RSDK::ClearSfxCache()
+{
+    for (int32 c = 0; c < SFXCACHE_COUNT; ++c) MEM_ZERO(sfxCache[c]);
+}
+#endif
+
+#if !RETRO_USE_ORIGINAL_CODE
+void RSDK::BuildSfxIndex()
+{
+    sfxIndex.Reset();
+    for (int32 s = 0; s < SFX_COUNT; ++s) sfxIndex.Add(sfxList[s].hash, s);
+}
+
+void SetSfxSlotHash(uint8 slot, uint32 *hash)
+{
+    if (sfxIndex.valid && !HASH_MATCH_MD5(sfxList[slot].hash, hash)) {
+        // overwriting a loaded sfx could uncover another slot with the same name, let GetSfx rebuild it in that case
+        if (sfxList[slot].hash[0] | sfxList[slot].hash[1] | sfxList[slot].hash[2] | sfxList[slot].hash[3])
+            sfxIndex.Invalidate();
+        else
+            sfxIndex.Add(hash, slot);
+    }
+
+    HASH_COPY_MD5(sfxList[slot].hash, hash);
+}
+#endif
+
 void RSDK::LoadSfxToSlot(char *filename, uint8 slot, uint8 plays, uint8 scope)
 {
     FileInfo info;
@@ -313,8 +710,26 @@ void RSDK::LoadSfxToSlot(char *filename, uint8 slot, uint8 plays, uint8 scope)
     RETRO_HASH_MD5(hash);
     GEN_HASH_MD5(filename, hash);
 
+#if !RETRO_USE_ORIGINAL_CODE
+    if (LoadSfxFromCache(hash, slot)) {
+        SetSfxSlotHash(slot, hash);
+        sfxList[slot].scope              = scope;
+        sfxList[slot].maxConcurrentPlays = plays;
+
+        AddProfileCount(PROFILE_SFX_CACHE_HITS, 1);
+        return;
+    }
+
+    AddProfileCount(PROFILE_SFX_CACHE_MISSES, 1);
+    BeginProfile(PROFILE_SFX_LOAD);
+#endif
+
     if (LoadFile(&info, fullFilePath, FMODE_RB)) {
+#if !RETRO_USE_ORIGINAL_CODE
+        SetSfxSlotHash(slot, hash);
+#else
         HASH_COPY_MD5(sfxList[slot].hash, hash);
+#endif
         sfxList[slot].scope              = scope;
         sfxList[slot].maxConcurrentPlays = plays;
 
@@ -362,6 +777,7 @@ void RSDK::LoadSfxToSlot(char *filename, uint8 slot, uint8 plays, uint8 scope)
                             // This can cause a crash because the SFX is incomplete.
 #if !RETRO_USE_ORIGINAL_CODE
                             PrintLog(PRINT_ERROR, "Unable to read sfx: %s", filename);
+                            EndProfile(PROFILE_SFX_LOAD);
 #endif
                             return;
                         }
@@ -376,8 +792,38 @@ void RSDK::LoadSfxToSlot(char *filename, uint8 slot, uint8 plays, uint8 scope)
                     length /= 2;
 
                 AllocateStorage((void **)&sfxList[slot].buffer, sizeof(float) * length, DATASET_SFX, false);
+#if !RETRO_USE_ORIGINAL_CODE
+                if (!sfxList[slot].buffer) {
+                    // out of room, drop the cache's hold on any sfx that aren't loaded & try again
+                    ClearSfxCache();
+                    AllocateStorage((void **)&sfxList[slot].buffer, sizeof(float) * length, DATASET_SFX, false);
+                }
+
+                if (!sfxList[slot].buffer) {
+                    PrintLog(PRINT_ERROR, "Unable to allocate sfx: %s", filename);
+                    MEM_ZERO(sfxList[slot]);
+                    sfxList[slot].scope = SCOPE_NONE;
+                    sfxIndex.Invalidate();
+
+                    CloseFile(&info);
+                    EndProfile(PROFILE_SFX_LOAD);
+                    return;
+                }
+#endif
                 sfxList[slot].length = length;
 
+#if !RETRO_USE_ORIGINAL_CODE
+                // Read all the sample data in one go into the back end of the buffer, then convert it to F32 in place.
+                uint32 sampleSize = sampleBits == 8 ? sizeof(uint8) : sizeof(int16);
+                uint8 *samples    = (uint8 *)sfxList[slot].buffer + length * (sizeof(float) - sampleSize);
+
+                size_t bytesRead = ReadBytes(&info, samples, length * sampleSize);
+                if (bytesRead < length * sampleSize)
+                    memset(&samples[bytesRead], 0, length * sampleSize - bytesRead);
+
+                ConvertSfxSamples(sfxList[slot].buffer, samples, length, sampleBits);
+                AddSfxToCache(hash, slot);
+#else
                 // Convert the sample data to F32 format
                 float *buffer = (float *)sfxList[slot].buffer;
                 if (sampleBits == 8) {
@@ -400,6 +846,7 @@ void RSDK::LoadSfxToSlot(char *filename, uint8 slot, uint8 plays, uint8 scope)
                         *buffer++ = (sample / (float)0x8000) * 0.75f;
                     }
                 }
+#endif
             }
 #if !RETRO_USE_ORIGINAL_CODE
             else {
@@ -421,6 +868,10 @@ void RSDK::LoadSfxToSlot(char *filename, uint8 slot, uint8 plays, uint8 scope)
 #endif
 
     CloseFile(&info);
+
+#if !RETRO_USE_ORIGINAL_CODE
+    EndProfile(PROFILE_SFX_LOAD);
+#endif
 }
 
 void RSDK::LoadSfx(char *filename, uint8 plays, uint8 scope)
@@ -570,6 +1021,10 @@ void RSDK::ClearStageSfx()
         }
     }
 
+#if !RETRO_USE_ORIGINAL_CODE
+    sfxIndex.Invalidate();
+#endif
+
     UnlockAudioDevice();
 }
 
@@ -594,6 +1049,10 @@ void RSDK::ClearGlobalSfx()
         }
     }
 
+#if !RETRO_USE_ORIGINAL_CODE
+    sfxIndex.Invalidate();
+#endif
+
     UnlockAudioDevice();
 }
 #endif
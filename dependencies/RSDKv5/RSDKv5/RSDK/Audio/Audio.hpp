@@ -36,10 +36,28 @@ struct ChannelInfo {
     uint8 state;
 };
 
+#if !RETRO_USE_ORIGINAL_CODE
+// Decoded sfx are kept around (up to SFXCACHE_SIZE bytes worth) after their scene unloads,
+// so revisiting a stage or reloading an act doesn't need to read & convert the same WAVs again
+#define SFXCACHE_COUNT (0x100)
+#define SFXCACHE_SIZE  (16 * 1024 * 1024)
+
+struct SFXCacheEntry {
+    RETRO_HASH_MD5(hash);
+    float *buffer;
+    size_t length;
+    uint32 lastUsed;
+};
+#endif
+
 enum ChannelStates { CHANNEL_IDLE, CHANNEL_SFX, CHANNEL_STREAM, CHANNEL_LOADING_STREAM, CHANNEL_PAUSED = 0x40 };
 
 extern SFXInfo sfxList[SFX_COUNT];
 extern ChannelInfo channels[CHANNEL_COUNT];
+#if !RETRO_USE_ORIGINAL_CODE
+extern SFXCacheEntry sfxCache[SFXCACHE_COUNT];
+extern HashIndexMD5<SFX_COUNT * 2> sfxIndex;
+#endif
 
 class AudioDeviceBase
 {
@@ -85,17 +103,28 @@ void LoadSfx(char *filePath, uint8 plays, uint8 scope);
 namespace RSDK
 {
 
+#if !RETRO_USE_ORIGINAL_CODE
+void BuildSfxIndex();
+#endif
+
 inline uint16 GetSfx(const char *sfxName)
 {
     RETRO_HASH_MD5(hash);
     GEN_HASH_MD5(sfxName, hash);
 
+#if !RETRO_USE_ORIGINAL_CODE
+    if (!sfxIndex.valid)
+        BuildSfxIndex();
+
+    return sfxIndex.Find(hash);
+#else
     for (int32 s = 0; s < SFX_COUNT; ++s) {
         if (HASH_MATCH_MD5(sfxList[s].hash, hash))
             return s;
     }
 
     return -1;
+#endif
 }
 int32 PlaySfx(uint16 sfx, uint32 loopPoint, uint32 priority);
 inline void StopSfx(uint16 sfx)
@@ -198,6 +227,9 @@ void ClearStageSfx();
 #if RETRO_USE_MOD_LOADER
 void ClearGlobalSfx();
 #endif
+#if !RETRO_USE_ORIGINAL_CODE
+void ClearSfxCache();
+#endif
 
 #if RETRO_REV0U
 #include "Legacy/AudioLegacy.hpp"
@@ -13,6 +13,10 @@ RSDK::SKU::UnknownInfo RSDK::SKU::unknownInfo;
 #else
 RSDK::APITableEntry RSDK::APIFunctionTable[APITABLE_COUNT];
 int32 RSDK::APIFunctionTableCount;
+
+#if !RETRO_USE_ORIGINAL_CODE
+HashIndexMD5<APITABLE_COUNT * 2> APIFunctionIndex;
+#endif
 #endif
 
 RSDK::GameVersionInfo RSDK::gameVerInfo;
@@ -31,10 +35,21 @@ void SetAPIFunction(const char *name, void *ptr)
         RETRO_HASH_MD5(hash);
         GEN_HASH_MD5(name, hash);
 
+#if !RETRO_USE_ORIGINAL_CODE
+        // entries are never removed, so the index only needs setting up once
+        if (!APIFunctionIndex.valid)
+            APIFunctionIndex.Reset();
+
+        if (APIFunctionIndex.Find(hash) >= 0)
+            return; // already exists, ignore this call
+
+        APIFunctionIndex.Add(hash, APIFunctionTableCount);
+#else
         for (int32 f = 0; f < APIFunctionTableCount; ++f) {
             if (HASH_MATCH_MD5(hash, APIFunctionTable[f].hash))
                 return; // already exists, ignore this call
         }
+#endif
 
         HASH_COPY_MD5(APIFunctionTable[APIFunctionTableCount].hash, hash);
         APIFunctionTable[APIFunctionTableCount].ptr = ptr;
@@ -50,10 +65,16 @@ void *GetAPIFunction(const char *name)
     RETRO_HASH_MD5(hash);
     GEN_HASH_MD5(name, hash);
 
+#if !RETRO_USE_ORIGINAL_CODE
+    int32 f = APIFunctionIndex.valid ? APIFunctionIndex.Find(hash) : -1;
+    if (f >= 0)
+        return APIFunctionTable[f].ptr;
+#else
     for (int32 f = 0; f < APIFunctionTableCount; ++f) {
         if (HASH_MATCH_MD5(hash, APIFunctionTable[f].hash))
             return APIFunctionTable[f].ptr;
     }
+#endif
 
     if (engine.consoleEnabled)
         PrintLog(PRINT_POPUP, "API Function not found: %s", name);
@@ -533,6 +554,12 @@ void RSDK::SetupFunctionTables()
     ADD_RSDK_FUNCTION(FunctionTable_SetGameFinished, SetGameFinished);
 #endif
 
+    // Math (Batched)
+#if !RETRO_USE_ORIGINAL_CODE
+    ADD_RSDK_FUNCTION(FunctionTable_RotatePoints, RotatePoints);
+    ADD_RSDK_FUNCTION(FunctionTable_ATan2Batch, ATan2Batch);
+#endif
+
 #if RETRO_USE_MOD_LOADER
     InitModAPI();
 #endif
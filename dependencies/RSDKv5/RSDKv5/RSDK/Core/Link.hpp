@@ -322,6 +322,11 @@ enum FunctionTableIDs {
 #if RETRO_REV0U
     FunctionTable_NotifyCallback,
     FunctionTable_SetGameFinished,
+#endif
+#if !RETRO_USE_ORIGINAL_CODE
+    // kept at the end so the original layout stays intact
+    FunctionTable_RotatePoints,
+    FunctionTable_ATan2Batch,
 #endif
     FunctionTable_Count,
 };
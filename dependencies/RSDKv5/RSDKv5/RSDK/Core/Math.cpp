@@ -1,8 +1,16 @@
 #include "RSDK/Core/RetroEngine.hpp"
 #include <math.h>
 
+#if RETRO_USE_SSE2
+#include <emmintrin.h>
+#endif
+
 using namespace RSDK;
 
+#if !RETRO_USE_ORIGINAL_CODE
+// the tables are baked in rather than built by CalculateTrigAngles on every boot
+#include "RSDK/Core/MathTables.hpp"
+#else
 int32 RSDK::sin1024LookupTable[0x400];
 int32 RSDK::cos1024LookupTable[0x400];
 int32 RSDK::tan1024LookupTable[0x400];
@@ -22,11 +30,14 @@ int32 RSDK::asin256LookupTable[0x100];
 int32 RSDK::acos256LookupTable[0x100];
 
 uint8 RSDK::arcTan256LookupTable[0x100 * 0x100];
+#endif
 
 uint32 RSDK::randSeed = 0;
 
 void RSDK::ClearTrigLookupTables()
 {
+    // the baked tables can't be rebuilt, so only the seed gets reset
+#if RETRO_USE_ORIGINAL_CODE
     memset(sin256LookupTable, 0, sizeof(sin256LookupTable));
     memset(cos256LookupTable, 0, sizeof(cos256LookupTable));
     memset(tan256LookupTable, 0, sizeof(tan256LookupTable));
@@ -43,6 +54,7 @@ void RSDK::ClearTrigLookupTables()
     memset(asin1024LookupTable, 0, sizeof(asin1024LookupTable));
     memset(acos1024LookupTable, 0, sizeof(acos1024LookupTable));
     memset(arcTan256LookupTable, 0, sizeof(arcTan256LookupTable));
+#endif
     randSeed = 0;
 }
 
@@ -51,6 +63,7 @@ void RSDK::CalculateTrigAngles()
     srand((uint32)time(NULL));
     randSeed = rand();
 
+#if RETRO_USE_ORIGINAL_CODE
     for (int32 i = 0; i < 0x400; ++i) {
         sin1024LookupTable[i]  = (int32)(sinf((i / 512.f) * RSDK_PI) * 1024.f);
         cos1024LookupTable[i]  = (int32)(cosf((i / 512.f) * RSDK_PI) * 1024.f);
@@ -104,6 +117,7 @@ void RSDK::CalculateTrigAngles()
             arcTan += 0x100;
         }
     }
+#endif
 }
 
 uint8 RSDK::ArcTanLookup(int32 X, int32 Y)
@@ -134,3 +148,90 @@ uint8 RSDK::ArcTanLookup(int32 X, int32 Y)
     else
         return arcTan256LookupTable[(x << 8) + y];
 }
+
+#if !RETRO_USE_ORIGINAL_CODE
+#if RETRO_USE_SSE2
+// SSE2 has no 32-bit mullo, so multiply the even & odd lanes separately and keep the low halves
+inline __m128i RotateMul(__m128i a, __m128i b)
+{
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd  = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+#endif
+
+void RSDK::RotatePoints(Vector2 *points, int32 count, Vector2 *origin, int32 angle)
+{
+    int32 sine   = Sin256(angle);
+    int32 cosine = Cos256(angle);
+    int32 i      = 0;
+
+#if RETRO_USE_SSE2
+    // 2 points per vector as x0, y0, x1, y1
+    __m128i pivot  = _mm_set_epi32(origin->y, origin->x, origin->y, origin->x);
+    __m128i cosVec = _mm_set1_epi32(cosine);
+    __m128i sinVec = _mm_set_epi32(-sine, sine, -sine, sine);
+    for (; i + 2 <= count; i += 2) {
+        __m128i offset  = _mm_srai_epi32(_mm_sub_epi32(_mm_loadu_si128((const __m128i *)&points[i]), pivot), 8);
+        __m128i swapped = _mm_shuffle_epi32(offset, _MM_SHUFFLE(2, 3, 0, 1));
+        __m128i result  = _mm_add_epi32(pivot, _mm_add_epi32(RotateMul(offset, cosVec), RotateMul(swapped, sinVec)));
+        _mm_storeu_si128((__m128i *)&points[i], result);
+    }
+#endif
+
+    // same maths as Zone_RotateOnPivot, so the results match the per-point version exactly
+    for (; i < count; ++i) {
+        int32 x     = (points[i].x - origin->x) >> 8;
+        int32 y     = (points[i].y - origin->y) >> 8;
+        points[i].x = origin->x + y * sine + x * cosine;
+        points[i].y = origin->y + y * cosine - x * sine;
+    }
+}
+
+void RSDK::ATan2Batch(const Vector2 *vectors, uint8 *angles, int32 count)
+{
+    int32 i = 0;
+
+#if RETRO_USE_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 4 <= count; i += 4) {
+        __m128i vecX = _mm_set_epi32(vectors[i + 3].x, vectors[i + 2].x, vectors[i + 1].x, vectors[i].x);
+        __m128i vecY = _mm_set_epi32(vectors[i + 3].y, vectors[i + 2].y, vectors[i + 1].y, vectors[i].y);
+
+        __m128i signX = _mm_srai_epi32(vecX, 31);
+        __m128i signY = _mm_srai_epi32(vecY, 31);
+        __m128i x     = _mm_sub_epi32(_mm_xor_si128(vecX, signX), signX);
+        __m128i y     = _mm_sub_epi32(_mm_xor_si128(vecY, signY), signY);
+
+        // ArcTanLookup shifts both by 4 until the larger one fits in a byte, each pass here stands in for one of those loops
+        __m128i yLarger = _mm_cmpgt_epi32(y, x);
+        __m128i larger  = _mm_or_si128(_mm_and_si128(yLarger, y), _mm_andnot_si128(yLarger, x));
+        for (int32 s = 0; s < 6; ++s) {
+            __m128i shift = _mm_cmpgt_epi32(larger, _mm_set1_epi32((0x100 << (s * 4)) - 1));
+            x             = _mm_or_si128(_mm_and_si128(shift, _mm_srai_epi32(x, 4)), _mm_andnot_si128(shift, x));
+            y             = _mm_or_si128(_mm_and_si128(shift, _mm_srai_epi32(y, 4)), _mm_andnot_si128(shift, y));
+        }
+
+        union {
+            __m128i v;
+            int32 lanes[4];
+        } index;
+        index.v       = _mm_add_epi32(_mm_slli_epi32(x, 8), y);
+        __m128i angle = _mm_set_epi32(arcTan256LookupTable[index.lanes[3]], arcTan256LookupTable[index.lanes[2]],
+                                      arcTan256LookupTable[index.lanes[1]], arcTan256LookupTable[index.lanes[0]]);
+
+        // the quadrant fixups: negate when exactly one of X & Y is positive, and add 0x80 when X isn't
+        __m128i right  = _mm_cmpgt_epi32(vecX, zero);
+        __m128i negate = _mm_xor_si128(right, _mm_cmpgt_epi32(vecY, zero));
+        angle          = _mm_sub_epi32(_mm_xor_si128(angle, negate), negate);
+        angle          = _mm_and_si128(_mm_add_epi32(angle, _mm_andnot_si128(right, _mm_set1_epi32(0x80))), _mm_set1_epi32(0xFF));
+
+        angle = _mm_packus_epi16(_mm_packs_epi32(angle, zero), zero);
+        int32 packed = _mm_cvtsi128_si32(angle);
+        memcpy(&angles[i], &packed, sizeof(packed));
+    }
+#endif
+
+    for (; i < count; ++i) angles[i] = ArcTanLookup(vectors[i].x, vectors[i].y);
+}
+#endif
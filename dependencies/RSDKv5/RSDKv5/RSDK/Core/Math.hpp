@@ -112,6 +112,12 @@ inline int32 ACos256(int32 angle)
 // Get Arc Tan value
 uint8 ArcTanLookup(int32 x, int32 y);
 
+#if !RETRO_USE_ORIGINAL_CODE
+// batch versions, these give the same results as doing each one separately
+void RotatePoints(Vector2 *points, int32 count, Vector2 *origin, int32 angle);
+void ATan2Batch(const Vector2 *vectors, uint8 *angles, int32 count);
+#endif
+
 extern uint32 randSeed;
 
 inline void SetRandSeed(int32 key) { randSeed = key; }
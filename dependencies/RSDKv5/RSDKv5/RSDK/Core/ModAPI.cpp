@@ -83,13 +83,13 @@ static bool PS3_ListDirectory(const std::string& path, std::vector<std::pair<std
     return true;
 }
 
-// Recursive listing for files
+// Recursive listing for files, foundDirPaths (if set) gets every directory visited, starting with currentRelPath itself
 static bool PS3_ListDirectoryRecursive(
     const std::string& basePath,
     const std::string& currentRelPath,
-    std::vector<std::string>& foundFilePaths
+    std::vector<std::string>& foundFilePaths,
+    std::vector<std::string>* foundDirPaths = NULL
 ) {
-    RSDK::PrintLog(RSDK::PRINT_NORMAL, "[MODS_FS_PS3] RecursiveScan START: Path='%s', RelPath='%s'", basePath.c_str(), currentRelPath.c_str());
     std::string currentAbsolutePath = basePath;
     if (!currentRelPath.empty()) {
         if (basePath.back() == '/' && currentRelPath.front() == '/') { // Avoid double slashes
@@ -107,33 +107,33 @@ static bool PS3_ListDirectoryRecursive(
         return false;
     }
 
+    if (foundDirPaths)
+        foundDirPaths->push_back(currentRelPath);
+
+    // no logging per entry in here, a big mod has thousands of them & every log line is a file write
     struct dirent *entry;
     while ((entry = readdir(dir)) != NULL) {
         std::string name = entry->d_name;
         if (name == "." || name == "..") {
             continue;
         }
-        RSDK::PrintLog(RSDK::PRINT_NORMAL, "[MODS_FS_PS3]   Found entry: '%s' in '%s'", name.c_str(), currentAbsolutePath.c_str());
         std::string entryAbsolutePath = currentAbsolutePath + "/" + name;
         std::string entryRelativePath = currentRelPath.empty() ? name : currentRelPath + "/" + name;
         
         struct stat entryStat;
         if (stat(entryAbsolutePath.c_str(), &entryStat) == 0) {
             if (S_ISDIR(entryStat.st_mode)) {
-                RSDK::PrintLog(RSDK::PRINT_NORMAL, "[MODS_FS_PS3]     Descending into: '%s'", entryRelativePath.c_str());
-                PS3_ListDirectoryRecursive(basePath, entryRelativePath, foundFilePaths);
+                PS3_ListDirectoryRecursive(basePath, entryRelativePath, foundFilePaths, foundDirPaths);
             } else {
                 // Store the relative path with its original casing.
                 // Normalization will be handled in ScanModFolder.
                 foundFilePaths.push_back(entryRelativePath);
-                RSDK::PrintLog(RSDK::PRINT_NORMAL, "[MODS_FS_PS3]       Added file: '%s'", entryRelativePath.c_str());
             }
         } else {
             RSDK::PrintLog(RSDK::PRINT_ERROR, "[MODS] PS3_ListDirectoryRecursive: Cannot stat file/directory: %s", entryAbsolutePath.c_str());
         }
     }
     closedir(dir);
-    RSDK::PrintLog(RSDK::PRINT_NORMAL, "[MODS_FS_PS3] RecursiveScan END: Path='%s', RelPath='%s'", basePath.c_str(), currentRelPath.c_str());
     return true;
 }
 #endif // __PS3__ or older GCC
@@ -182,6 +182,8 @@ std::vector<ObjectClass *> allocatedInherits;
 ModSettings RSDK::modSettings;
 std::vector<ModInfo> RSDK::modList;
 std::vector<ModCallbackSTD> RSDK::modCallbackList[MODCB_MAX];
+std::vector<ModCallbackEntry> RSDK::modCallbackEntries[MODCB_MAX];
+uint32 RSDK::modCallbackMask = 0;
 std::vector<StateHook> RSDK::stateHookList;
 std::vector<ObjectHook> RSDK::objectHookList;
 ModVersionInfo RSDK::targetModVersion = { RETRO_REVISION, 0, RETRO_MOD_LOADER_VER };
@@ -329,6 +331,24 @@ void RSDK::InitModAPI(bool32 getVersion)
     ADD_MOD_FUNCTION(ModTable_GetCollisionInfo, GetCollisionInfo);
 #endif
 
+#if RETRO_MOD_LOADER_VER >= 3
+    // Scenes
+    ADD_MOD_FUNCTION(ModTable_PreloadScene, PreloadScene);
+
+    // Objects/Entities
+    ADD_MOD_FUNCTION(ModTable_GetActiveEntitiesInBounds, GetActiveEntitiesInBounds);
+    ADD_MOD_FUNCTION(ModTable_SetIsolatedUpdate, SetIsolatedUpdate);
+
+    // Collision
+    ADD_MOD_FUNCTION(ModTable_CheckObjectCollisionTouchBatch, CheckObjectCollisionTouchBatch);
+
+    // Snapshots
+    ADD_MOD_FUNCTION(ModTable_CaptureSnapshot, CaptureSnapshot);
+    ADD_MOD_FUNCTION(ModTable_RestoreSnapshot, RestoreSnapshot);
+    ADD_MOD_FUNCTION(ModTable_GetSnapshotRange, GetSnapshotRange);
+    ADD_MOD_FUNCTION(ModTable_ClearSnapshots, ClearSnapshots);
+#endif
+
     superLevels.clear();
     inheritLevel = 0;
     RSDK::PrintLog(RSDK::PRINT_NORMAL, "[MOD_FLOW] InitModAPI: Calling LoadMods().");
@@ -350,6 +370,7 @@ void RSDK::SortMods()
         }
     }
 
+    InvalidateModFileIndex();
     std::stable_sort(modList.begin(), modList.end(), [](const ModInfo &a, const ModInfo &b) {
         if (!(a.active && b.active))
             return a.active;
@@ -410,6 +431,7 @@ void RSDK::ApplyModChanges()
     uint32 category                      = sceneInfo.activeCategory;
     uint32 scene                         = sceneInfo.listPos;
     dataStorage[DATASET_SFX].usedStorage = 0;
+    ClearSfxCache(); // its entries point into the pool that was just reset
     RefreshModFolders(true);
     LoadModSettings();
     DetectEngineVersion();
@@ -448,6 +470,7 @@ void RSDK::ApplyModChanges()
     uint32 category                      = sceneInfo.activeCategory;
     uint32 scene                         = sceneInfo.listPos;
     dataStorage[DATASET_SFX].usedStorage = 0;
+    ClearSfxCache(); // its entries point into the pool that was just reset
     RefreshModFolders(true);
     LoadModSettings();
     LoadGameConfig();
@@ -476,6 +499,119 @@ void DrawStatus(const char *str)
 #define RENDER_COUNT  (200)
 #endif
 
+// a full scan of a mod folder is cooked per mod (named after the MD5 of the mod's path), so unchanged mods skip the scan next boot
+// every directory's mtime is kept with it, adding/removing/renaming anything in a folder changes that folder's mtime
+struct ModFolderListingHeader {
+    int32 dirCount;
+    int32 fileCount;
+    int32 stringSize;
+};
+
+struct ModFolderListing {
+    std::vector<std::string> dirs;  // relative to the mod folder, "" is the mod folder itself
+    std::vector<std::string> files; // relative to the mod folder, original case
+};
+
+static bool32 GetModDirTime(const std::string &modDir, const std::string &relPath, int64 *time)
+{
+    std::string path = relPath.empty() ? modDir : modDir + "/" + relPath;
+#if !defined(__PS3__) && (!defined(__GNUC__) || __GNUC__ >= 8)
+    std::error_code error;
+    if (!fs::is_directory(fs::path(path), error))
+        return false;
+
+    fs::file_time_type writeTime = fs::last_write_time(fs::path(path), error);
+    if (error)
+        return false;
+    *time = (int64)writeTime.time_since_epoch().count();
+#else
+    struct stat dirStat;
+    if (stat(path.c_str(), &dirStat) != 0 || !S_ISDIR(dirStat.st_mode))
+        return false;
+    *time = (int64)dirStat.st_mtime;
+#endif
+    return true;
+}
+
+static bool32 LoadModFolderListing(ModInfo *info, CookedAsset *cache)
+{
+    RETRO_HASH_MD5(hash);
+    GenerateHashMD5(hash, (char *)info->path.c_str(), (int32)info->path.length());
+    if (!LoadCookedAssetByHash(cache, hash, (int32)info->path.length(), COOKED_MODFILES))
+        return false;
+
+    ModFolderListingHeader header;
+    ReadCookedBlock(cache, &header, sizeof(header));
+    if (header.dirCount <= 0 || header.fileCount < 0 || header.stringSize <= 0
+        || (int64)header.dirCount * (int64)sizeof(int64) + header.stringSize > (int64)cache->info.fileSize) {
+        CloseCookedAsset(cache);
+        return false;
+    }
+
+    std::vector<int64> dirTimes(header.dirCount);
+    std::vector<char> strings(header.stringSize);
+    ReadCookedBlock(cache, dirTimes.data(), header.dirCount * sizeof(int64));
+    ReadCookedBlock(cache, strings.data(), header.stringSize);
+    CloseCookedAsset(cache);
+    if (strings.back())
+        return false;
+
+    // the strings are dirs first then files, all null terminated
+    const char *str    = strings.data();
+    const char *strEnd = str + header.stringSize;
+    for (int32 d = 0; d < header.dirCount; ++d, str += strlen(str) + 1) {
+        int64 time = 0;
+        if (str >= strEnd || !GetModDirTime(info->path, str, &time) || time != dirTimes[d])
+            return false;
+    }
+
+    for (int32 f = 0; f < header.fileCount; ++f, str += strlen(str) + 1) {
+        if (str >= strEnd) {
+            info->fileMap.clear();
+            return false;
+        }
+
+        std::string folderPath = str;
+        std::transform(folderPath.begin(), folderPath.end(), folderPath.begin(),
+                       [](unsigned char c) { return c == '\\' ? '/' : std::tolower(c); });
+        info->fileMap.insert(std::pair<std::string, std::string>(folderPath, info->path + "/" + str));
+    }
+
+    return true;
+}
+
+static void DrawModScanFinished(int32 dx, int32 dy)
+{
+    DrawRectangle(dx - 0x80 + 0x10, dy + 48, 0x100 - 0x20, 0x10, 0x000080, 0xFF, INK_NONE, true);
+
+    RenderDevice::CopyFrameBuffer();
+    RenderDevice::FlipScreen();
+}
+
+static void SaveModFolderListing(CookedAsset *cache, ModInfo *info, ModFolderListing *listing)
+{
+    if (!cache->filePath[0] || listing->dirs.empty())
+        return;
+
+    std::vector<int64> dirTimes(listing->dirs.size());
+    std::vector<char> strings;
+    for (int32 d = 0; d < (int32)listing->dirs.size(); ++d) {
+        if (!GetModDirTime(info->path, listing->dirs[d], &dirTimes[d]))
+            return;
+        strings.insert(strings.end(), listing->dirs[d].c_str(), listing->dirs[d].c_str() + listing->dirs[d].length() + 1);
+    }
+    for (auto &file : listing->files) strings.insert(strings.end(), file.c_str(), file.c_str() + file.length() + 1);
+
+    ModFolderListingHeader header;
+    header.dirCount   = (int32)listing->dirs.size();
+    header.fileCount  = (int32)listing->files.size();
+    header.stringSize = (int32)strings.size();
+
+    void *blocks[]     = { &header, dirTimes.data(), strings.data() };
+    int32 blockSizes[] = { sizeof(header), header.dirCount * (int32)sizeof(int64), header.stringSize };
+    SaveCookedAsset(cache, blocks, blockSizes, 3);
+}
+
 bool32 RSDK::ScanModFolder(ModInfo *info, const char *targetFile, bool32 fromLoadMod, bool32 loadingBar)
 {
     if (!info)
@@ -483,6 +619,7 @@ bool32 RSDK::ScanModFolder(ModInfo *info, const char *targetFile, bool32 fromLoa
 
     const std::string modDir = info->path;
 
+    InvalidateModFileIndex();
     if (!targetFile)
         info->fileMap.clear();
 
@@ -508,6 +645,16 @@ bool32 RSDK::ScanModFolder(ModInfo *info, const char *targetFile, bool32 fromLoa
         // Normalize slashes for consistency if needed, though primarily for map keys
         std::replace(targetFileStr.begin(), targetFileStr.end(), '\\', '/');
     }
+
+    CookedAsset listingCache;
+    listingCache.filePath[0] = 0;
+    ModFolderListing listing;
+    if (!targetFile && LoadModFolderListing(info, &listingCache)) {
+        PrintLog(PRINT_NORMAL, "[MOD] Using cached file list for %s (%d files)", info->id.c_str(), (int32)info->fileMap.size());
+        if (loadingBar && fromLoadMod)
+            DrawModScanFinished(dx, dy);
+        return true;
+    }
     
 #if !defined(__PS3__) && (!defined(__GNUC__) || __GNUC__ >= 8)
     if (targetFile) {
@@ -536,7 +683,11 @@ bool32 RSDK::ScanModFolder(ModInfo *info, const char *targetFile, bool32 fromLoa
             int32 renders = 1;
             int32 size    = 0;
 
+            listing.dirs.push_back("");
             for (auto dirFile : dirIterator) {
+                if (dirFile.is_directory())
+                    listing.dirs.push_back(dirFile.path().string().substr(fs::path(dataPathStr).string().length() + 1));
+
 #if RETRO_PLATFORM != RETRO_ANDROID
                 if (!dirFile.is_directory()) {
 #endif
@@ -558,6 +709,7 @@ bool32 RSDK::ScanModFolder(ModInfo *info, const char *targetFile, bool32 fromLoa
 
             for (auto dirFile : files) {
                 std::string folderPath = dirFile.path().string().substr(fs::path(dataPathStr).string().length() + 1); // fs::path used
+                listing.files.push_back(folderPath);
                 std::transform(folderPath.begin(), folderPath.end(), folderPath.begin(),
                                [](unsigned char c) { return c == '\\' ? '/' : std::tolower(c); });
 
@@ -572,6 +724,8 @@ bool32 RSDK::ScanModFolder(ModInfo *info, const char *targetFile, bool32 fromLoa
                     RenderDevice::FlipScreen();
                 }
             }
+
+            SaveModFolderListing(&listingCache, info, &listing);
         } catch (fs::filesystem_error &fe) {
             PrintLog(PRINT_ERROR, "Mod File Scanning Error: %s", fe.what());
         }
@@ -600,7 +754,7 @@ bool32 RSDK::ScanModFolder(ModInfo *info, const char *targetFile, bool32 fromLoa
         RSDK::PrintLog(RSDK::PRINT_NORMAL, "[MODS_SCAN] Scanning mod folder (PS3): Mod='%s', DataPath='%s'", info->id.c_str(), dataPathStr.c_str());
         // dataPathStr here is the mod's specific data folder, e.g., "mods/MyMod/Data"
         // Pass dataPathStr as basePath, and an empty string for currentRelPath to start.
-        if (PS3_ListDirectoryRecursive(dataPathStr, "", foundFiles)) {
+        if (PS3_ListDirectoryRecursive(dataPathStr, "", foundFiles, &listing.dirs)) {
             RSDK::PrintLog(RSDK::PRINT_NORMAL, "[MODS_SCAN]   PS3_ListDirectoryRecursive completed. Found %d files for mod '%s'.", (int)foundFiles.size(), info->id.c_str());
             int count = 0;
             if (foundFiles.empty()) {
@@ -619,24 +773,81 @@ bool32 RSDK::ScanModFolder(ModInfo *info, const char *targetFile, bool32 fromLoa
 
                 // The key is the normalized path, the value is the full path with original casing.
                 info->fileMap.insert(std::pair<std::string, std::string>(normalizedKeyPath, fullPathToModFile));
-                
-                RSDK::PrintLog(RSDK::PRINT_NORMAL, "[MODS_MAP][%d/%d] Mapped key: '%s' to value: '%s'", count, (int)foundFiles.size(), normalizedKeyPath.c_str(), fullPathToModFile.c_str());
             }
             RSDK::PrintLog(RSDK::PRINT_NORMAL, "[MODS_SCAN]   Finished populating fileMap for mod '%s'. Processed %d file(s).", info->id.c_str(), count);
+
+            listing.files.swap(foundFiles);
+            SaveModFolderListing(&listingCache, info, &listing);
         } else {
             RSDK::PrintLog(PRINT_ERROR, "[MODS] ScanModFolder: Failed to recursively list directory: %s", dataPathStr.c_str());
         }
     }
 #endif // !__PS3__ && GCC >=8 ELSE
 
-    if (loadingBar && fromLoadMod) {
-        DrawRectangle(dx - 0x80 + 0x10, dy + 48, 0x100 - 0x20, 0x10, 0x000080, 0xFF, INK_NONE, true);
+    if (loadingBar && fromLoadMod)
+        DrawModScanFinished(dx, dy);
+
+    return true;
+}
+
+// stateHookList grouped by state for dispatch, rebuilt whenever the list changes (hooks only get registered while mods load)
+// each state gets one slot in an open addressing table pointing at its hooks in stateHookFuncs, high priority first, both in registration order
+struct StateHookSlot {
+    void *state; // NULL == empty slot
+    int32 offset;
+    int32 highCount;
+    int32 lowCount;
+};
 
-        RenderDevice::CopyFrameBuffer();
-        RenderDevice::FlipScreen();
+static std::vector<StateHookSlot> stateHookTable;
+static std::vector<bool32 (*)(bool32 skippedState)> stateHookFuncs;
+
+static inline uint32 GetStateHookSlot(void *state, uint32 mask) { return (uint32)(((uintptr_t)state >> 2) * 0x9E3779B1) & mask; }
+
+static void BuildStateHookTable()
+{
+    stateHookTable.clear();
+    stateHookFuncs.clear();
+
+    std::vector<int32> order;
+    for (int32 h = 0; h < (int32)stateHookList.size(); ++h) {
+        if (stateHookList[h].hook)
+            order.push_back(h);
     }
 
-    return true;
+    if (order.empty())
+        return;
+
+    std::stable_sort(order.begin(), order.end(), [](int32 a, int32 b) {
+        if (stateHookList[a].state != stateHookList[b].state)
+            return (uintptr_t)stateHookList[a].state < (uintptr_t)stateHookList[b].state;
+        return stateHookList[a].priority && !stateHookList[b].priority;
+    });
+
+    uint32 size = 0x10;
+    while (size < order.size() * 2) size <<= 1;
+
+    StateHookSlot empty = { NULL, 0, 0, 0 };
+    stateHookTable.assign(size, empty);
+
+    for (int32 i = 0; i < (int32)order.size(); ++i) {
+        StateHook &hook = stateHookList[order[i]];
+
+        uint32 slot = GetStateHookSlot((void *)hook.state, size - 1);
+        while (stateHookTable[slot].state && stateHookTable[slot].state != (void *)hook.state) slot = (slot + 1) & (size - 1);
+
+        StateHookSlot *entry = &stateHookTable[slot];
+        if (!entry->state) {
+            entry->state  = (void *)hook.state;
+            entry->offset = (int32)stateHookFuncs.size();
+        }
+
+        if (hook.priority)
+            entry->highCount++;
+        else
+            entry->lowCount++;
+        stateHookFuncs.push_back(hook.hook);
+    }
 }
 
 void RSDK::UnloadMods()
@@ -653,8 +864,14 @@ void RSDK::UnloadMods()
     }
 
     modList.clear();
-    for (int32 c = 0; c < MODCB_MAX; ++c) modCallbackList[c].clear();
+    InvalidateModFileIndex();
+    for (int32 c = 0; c < MODCB_MAX; ++c) {
+        modCallbackList[c].clear();
+        modCallbackEntries[c].clear();
+    }
+    modCallbackMask = 0;
     stateHookList.clear();
+    BuildStateHookTable();
     objectHookList.clear();
 
     for (int32 i = 0; i < (int32)allocatedInherits.size(); ++i) {
@@ -683,6 +900,7 @@ void RSDK::UnloadMods()
     dataStorage[DATASET_STG].usedStorage = 0;
     DefragmentAndGarbageCollectStorage(DATASET_MUS);
     dataStorage[DATASET_SFX].usedStorage = 0;
+    ClearSfxCache();
     dataStorage[DATASET_STR].usedStorage = 0;
     dataStorage[DATASET_TMP].usedStorage = 0;
 
@@ -831,27 +1049,101 @@ bool32 RSDK::GetModConfigBool(const char *section, const char *key, bool32 defau
     return defaultValue;
 }
 
+// every active mod's files merged into one table, highest priority mod first with exclusions already applied
+// open addressing over a power of 2 size, the strings all live in one pool so building it doesn't allocate per file
+struct ModFileIndexEntry {
+    uint32 hash;
+    int32 modID; // -1 == empty slot
+    uint32 key;  // offsets into modFileIndexStrings
+    uint32 path;
+};
+
+static std::vector<ModFileIndexEntry> modFileIndex;
+static std::vector<char> modFileIndexStrings;
+static bool32 modFileIndexValid = false;
+
+// FNV-1a, keys are already lowercase with forward slashes
+static inline uint32 HashModFilePath(const char *path)
+{
+    uint32 hash = 0x811C9DC5;
+    while (*path) hash = (hash ^ (uint8)*path++) * 0x01000193;
+    return hash;
+}
+
+void RSDK::InvalidateModFileIndex() { modFileIndexValid = false; }
+
+static void BuildModFileIndex()
+{
+    int32 fileCount = 0;
+    for (ModInfo &mod : modList) {
+        if (mod.active)
+            fileCount += (int32)mod.fileMap.size();
+    }
+
+    uint32 size = 0x10;
+    while (size < (uint32)fileCount * 2) size <<= 1;
+
+    ModFileIndexEntry empty = { 0, -1, 0, 0 };
+    modFileIndex.assign(size, empty);
+    modFileIndexStrings.clear();
+
+    for (int32 m = modList.size() - 1; m >= 0; --m) {
+        ModInfo &mod = modList[m];
+        if (!mod.active)
+            continue;
+
+        for (auto &file : mod.fileMap) {
+            if (mod.excludedFiles.count(file.first))
+                continue;
+
+            uint32 hash = HashModFilePath(file.first.c_str());
+            uint32 slot = hash & (size - 1);
+            while (modFileIndex[slot].modID != -1
+                   && (modFileIndex[slot].hash != hash || strcmp(&modFileIndexStrings[modFileIndex[slot].key], file.first.c_str()) != 0))
+                slot = (slot + 1) & (size - 1);
+
+            // a higher priority mod already has this one
+            if (modFileIndex[slot].modID != -1)
+                continue;
+
+            ModFileIndexEntry *entry = &modFileIndex[slot];
+            entry->hash              = hash;
+            entry->modID             = m;
+            entry->key               = (uint32)modFileIndexStrings.size();
+            modFileIndexStrings.insert(modFileIndexStrings.end(), file.first.c_str(), file.first.c_str() + file.first.length() + 1);
+            entry->path = (uint32)modFileIndexStrings.size();
+            modFileIndexStrings.insert(modFileIndexStrings.end(), file.second.c_str(), file.second.c_str() + file.second.length() + 1);
+        }
+    }
+
+    modFileIndexValid = true;
+}
+
 const char *RSDK::FindModFile(const char *filePath)
 {
     static char fullFilePath[0x100];
 
-    char pathLower[0x100];
-    std::string tempPath = filePath;
-    std::replace(tempPath.begin(), tempPath.end(), '\\', '/');
-    strncpy(pathLower, tempPath.c_str(), sizeof(pathLower) - 1);
-    pathLower[sizeof(pathLower) - 1] = '\0';
-    StrToLower(pathLower);
+    if (!modFileIndexValid)
+        BuildModFileIndex();
 
-    for (int32 i = modList.size() - 1; i >= 0; --i) {
-        ModInfo &mod = modList[i];
-        if (mod.active) {
-            auto iter = mod.fileMap.find(pathLower);
-            if (iter != mod.fileMap.end()) {
-                if (std::find(mod.excludedFiles.begin(), mod.excludedFiles.end(), std::string(pathLower)) == mod.excludedFiles.end()) {
-                    strcpy(fullFilePath, iter->second.c_str());
-                    return fullFilePath;
-                }
-            }
+    // normalize & hash in one go, same as the keys ScanModFolder() makes
+    char pathLower[0x100];
+    uint32 hash = 0x811C9DC5;
+    int32 len   = 0;
+    for (; filePath[len] && len < (int32)sizeof(pathLower) - 1; ++len) {
+        char c         = filePath[len] == '\\' ? '/' : tolower(filePath[len]);
+        pathLower[len] = c;
+        hash           = (hash ^ (uint8)c) * 0x01000193;
+    }
+    pathLower[len] = 0;
+
+    uint32 mask = (uint32)modFileIndex.size() - 1;
+    for (uint32 slot = hash & mask; modFileIndex[slot].modID != -1; slot = (slot + 1) & mask) {
+        ModFileIndexEntry *entry = &modFileIndex[slot];
+        if (entry->hash == hash && !strcmp(&modFileIndexStrings[entry->key], pathLower)) {
+            strncpy(fullFilePath, &modFileIndexStrings[entry->path], sizeof(fullFilePath) - 1);
+            fullFilePath[sizeof(fullFilePath) - 1] = 0;
+            return fullFilePath;
         }
     }
 
@@ -963,14 +1255,16 @@ void RSDK::SaveMods()
     currentMod = cur;
 }
 
-void RSDK::RunModCallbacks(int32 callbackID, void *data)
+void RSDK::RunModCallbackList(int32 callbackID, void *data)
 {
-    if (callbackID < 0 || callbackID >= MODCB_MAX)
-        return;
+    ModCallbackEntry *entries = modCallbackEntries[callbackID].data();
+    int32 count               = (int32)modCallbackEntries[callbackID].size();
 
-    for (auto &c : modCallbackList[callbackID]) {
-        if (c)
-            c(data);
+    for (int32 c = 0; c < count; ++c) {
+        if (entries[c].callback)
+            entries[c].callback(data);
+        else
+            modCallbackList[callbackID][entries[c].stdCallbackID](data);
     }
 }
 
@@ -1029,6 +1323,15 @@ int32 RSDK::GetModCount(bool32 active)
     return c;
 }
 
+bool32 RSDK::HasActiveLogicMods()
+{
+    for (auto &m : modList) {
+        if (m.active && m.hasLogic)
+            return true;
+    }
+    return false;
+}
+
 const char *RSDK::GetModIDByIndex(uint32 index)
 {
     if (index >= modList.size())
@@ -1059,14 +1362,29 @@ bool32 RSDK::ForeachModID(String *id)
     return true;
 }
 
-void RSDK::AddModCallback(int32 callbackID, ModCallback callback) { return AddModCallback_STD(callbackID, callback); }
+void RSDK::AddModCallback(int32 callbackID, ModCallback callback)
+{
+    if (callbackID < 0 || callbackID >= MODCB_MAX || !callback)
+        return;
+
+    ModCallbackEntry entry;
+    entry.callback      = callback;
+    entry.stdCallbackID = -1;
+    modCallbackEntries[callbackID].push_back(entry);
+    modCallbackMask |= 1 << callbackID;
+}
 
 void RSDK::AddModCallback_STD(int32 callbackID, ModCallbackSTD callback)
 {
-    if (callbackID < 0 || callbackID >= MODCB_MAX)
+    if (callbackID < 0 || callbackID >= MODCB_MAX || !callback)
         return;
 
+    ModCallbackEntry entry;
+    entry.callback      = NULL;
+    entry.stdCallbackID = (int32)modCallbackList[callbackID].size();
     modCallbackList[callbackID].push_back(callback);
+    modCallbackEntries[callbackID].push_back(entry);
+    modCallbackMask |= 1 << callbackID;
 }
 
 void RSDK::AddPublicFunction(const char *functionName, void *functionPtr)
@@ -1881,31 +2199,70 @@ int32 RSDK::GetAchievementIndexByID(const char *id)
 }
 int32 RSDK::GetAchievementCount() { return (int32)achievementList.size(); }
 
-void RSDK::StateMachineRun(void (*state)())
+// the dispatchers below hold pointers into the table while hooks & states run, so any hooks registered by those are only added once they're done
+static int32 stateHookDispatchDepth  = 0;
+static bool32 stateHookRebuildQueued = false;
+
+static inline void EndStateHookDispatch()
 {
-    bool32 skipState = false;
+    if (!--stateHookDispatchDepth && stateHookRebuildQueued) {
+        stateHookRebuildQueued = false;
+        BuildStateHookTable();
+    }
+}
 
-    for (int32 h = 0; h < (int32)stateHookList.size(); ++h) {
-        if (stateHookList[h].priority && stateHookList[h].state == state && stateHookList[h].hook)
-            skipState |= stateHookList[h].hook(skipState);
+static inline const StateHookSlot *FindStateHooks(void *state)
+{
+    // no hooks at all, the common case
+    if (stateHookTable.empty())
+        return NULL;
+
+    uint32 mask = (uint32)stateHookTable.size() - 1;
+    for (uint32 slot = GetStateHookSlot(state, mask); stateHookTable[slot].state; slot = (slot + 1) & mask) {
+        if (stateHookTable[slot].state == state)
+            return &stateHookTable[slot];
+    }
+
+    return NULL;
+}
+
+void RSDK::StateMachineRun(void (*state)())
+{
+    const StateHookSlot *hooks = FindStateHooks((void *)state);
+    if (!hooks) {
+        if (state)
+            state();
+        return;
     }
 
+    stateHookDispatchDepth++;
+
+    bool32 skipState                               = false;
+    bool32 (*const *hookFuncs)(bool32 skippedState) = &stateHookFuncs[hooks->offset];
+
+    for (int32 h = 0; h < hooks->highCount; ++h) skipState |= hookFuncs[h](skipState);
+
     if (!skipState && state)
         state();
 
-    for (int32 h = 0; h < (int32)stateHookList.size(); ++h) {
-        if (!stateHookList[h].priority && stateHookList[h].state == state && stateHookList[h].hook)
-            stateHookList[h].hook(skipState);
-    }
+    hookFuncs += hooks->highCount;
+    for (int32 h = 0; h < hooks->lowCount; ++h) hookFuncs[h](skipState);
+
+    EndStateHookDispatch();
 }
 
 bool32 RSDK::HandleRunState_HighPriority(void *state)
 {
     bool32 skipState = false;
 
-    for (int32 h = 0; h < (int32)stateHookList.size(); ++h) {
-        if (stateHookList[h].priority && stateHookList[h].state == state && stateHookList[h].hook)
-            skipState |= stateHookList[h].hook(skipState);
+    const StateHookSlot *hooks = FindStateHooks(state);
+    if (hooks) {
+        stateHookDispatchDepth++;
+
+        bool32 (*const *hookFuncs)(bool32 skippedState) = &stateHookFuncs[hooks->offset];
+        for (int32 h = 0; h < hooks->highCount; ++h) skipState |= hookFuncs[h](skipState);
+
+        EndStateHookDispatch();
     }
 
     return skipState;
@@ -1913,9 +2270,14 @@ bool32 RSDK::HandleRunState_HighPriority(void *state)
 
 void RSDK::HandleRunState_LowPriority(void *state, bool32 skipState)
 {
-    for (int32 h = 0; h < (int32)stateHookList.size(); ++h) {
-        if (!stateHookList[h].priority && stateHookList[h].state == state && stateHookList[h].hook)
-            stateHookList[h].hook(skipState);
+    const StateHookSlot *hooks = FindStateHooks(state);
+    if (hooks) {
+        stateHookDispatchDepth++;
+
+        bool32 (*const *hookFuncs)(bool32 skippedState) = &stateHookFuncs[hooks->offset + hooks->highCount];
+        for (int32 h = 0; h < hooks->lowCount; ++h) hookFuncs[h](skipState);
+
+        EndStateHookDispatch();
     }
 }
 
@@ -1930,6 +2292,10 @@ void RSDK::RegisterStateHook(void (*state)(), bool32 (*hook)(bool32 skippedState
     stateHook.priority = priority;
 
     stateHookList.push_back(stateHook);
+    if (stateHookDispatchDepth)
+        stateHookRebuildQueued = true;
+    else
+        BuildStateHookTable();
 }
 
 #if RETRO_MOD_LOADER_VER >= 2
@@ -1956,10 +2322,8 @@ bool32 RSDK::ExcludeFile(const char *id, const char *path)
     memset(pathLower, 0, sizeof(pathLower));
     for (int32 c = 0; c < strlen(path); ++c) pathLower[c] = tolower(path[c]);
 
-    auto &excludeList = modList[m].excludedFiles;
-    if (std::find(excludeList.begin(), excludeList.end(), pathLower) == excludeList.end()) {
-        excludeList.push_back(std::string(pathLower));
-
+    if (modList[m].excludedFiles.insert(std::string(pathLower)).second) {
+        InvalidateModFileIndex();
         return true;
     }
 
@@ -1983,11 +2347,12 @@ bool32 RSDK::ExcludeAllFiles(const char *id)
         return false;
 
     auto &excludeList = modList[m].excludedFiles;
-    for (auto file : modList[m].fileMap) {
-        excludeList.push_back(file.first);
+    for (auto &file : modList[m].fileMap) {
+        excludeList.insert(file.first);
     }
 
     modList[m].fileMap.clear();
+    InvalidateModFileIndex();
 
     return true;
 }
@@ -2012,10 +2377,8 @@ bool32 RSDK::ReloadFile(const char *id, const char *path)
     memset(pathLower, 0, sizeof(pathLower));
     for (int32 c = 0; c < strlen(path); ++c) pathLower[c] = tolower(path[c]);
 
-    auto &excludeList = modList[m].excludedFiles;
-    if (std::find(excludeList.begin(), excludeList.end(), pathLower) != excludeList.end()) {
-        excludeList.erase(std::remove(excludeList.begin(), excludeList.end(), pathLower), excludeList.end());
-
+    if (modList[m].excludedFiles.erase(std::string(pathLower))) {
+        InvalidateModFileIndex();
         return true;
     }
 
@@ -6,6 +6,7 @@
 #include <string>
 #include <sstream>
 #include <map>
+#include <unordered_set>
 #include <regex>
 #include "tinyxml2.h"
 
@@ -140,12 +141,37 @@ enum ModFunctionTableIDs {
     ModTable_GetCollisionInfo,
 #endif
 
+#if RETRO_MOD_LOADER_VER >= 3
+    // Scenes
+    ModTable_PreloadScene,
+
+    // Objects/Entities
+    ModTable_GetActiveEntitiesInBounds,
+    ModTable_SetIsolatedUpdate,
+
+    // Collision
+    ModTable_CheckObjectCollisionTouchBatch,
+
+    // Snapshots
+    ModTable_CaptureSnapshot,
+    ModTable_RestoreSnapshot,
+    ModTable_GetSnapshotRange,
+    ModTable_ClearSnapshots,
+#endif
+
     ModTable_Count
 };
 
 typedef void (*ModCallback)(void *data);
 typedef std::function<void(void *data)> ModCallbackSTD;
 
+// what RunModCallbacks() actually walks, every registration for a callback ID in order
+// plain function pointers are called directly, std::function registrations stay in modCallbackList & are called through it
+struct ModCallbackEntry {
+    ModCallback callback;
+    int32 stdCallbackID;
+};
+
 typedef bool (*modLink)(EngineInfo *, const char *);
 typedef std::function<bool(EngineInfo *, const char *)> modLinkSTD;
 
@@ -188,7 +214,7 @@ struct ModInfo {
     int32 targetVersion;
     int32 forceVersion;
     std::map<std::string, std::string> fileMap;
-    std::vector<std::string> excludedFiles;
+    std::unordered_set<std::string> excludedFiles;
     std::vector<ModPublicFunctionInfo> functionList;
     std::vector<Link::Handle> modLogicHandles;
     std::vector<modLinkSTD> linkModLogic;
@@ -224,6 +250,9 @@ struct ModSettings {
 extern ModSettings modSettings;
 extern std::vector<ModInfo> modList;
 extern std::vector<ModCallbackSTD> modCallbackList[MODCB_MAX];
+extern std::vector<ModCallbackEntry> modCallbackEntries[MODCB_MAX];
+// bit per callback ID that has anything registered
+extern uint32 modCallbackMask;
 extern std::vector<StateHook> stateHookList;
 extern std::vector<ObjectHook> objectHookList;
 extern ModVersionInfo targetModVersion;
@@ -251,6 +280,11 @@ int32 GetModConfigInteger(const char *section, const char *key, int32 defaultVal
 bool32 GetModConfigBool(const char *section, const char *key, bool32 defaultValue);
 
 const char *FindModFile(const char *filePath);
+// FindModFile() works off one merged index of every active mod's files, rebuilt on the next lookup after this
+// anything that changes a fileMap, an exclusion list or the order/active state of modList needs to call it
+void InvalidateModFileIndex();
+// true if any active mod has a logic file, see UpdateEntityStride
+bool32 HasActiveLogicMods();
 bool32 ScanModFolder(ModInfo *info, const char *targetFile = nullptr, bool32 fromLoadMod = false, bool32 loadingBar = true);
 inline void RefreshModFolders(bool32 versionOnly = false, bool32 loadingBar = true)
 {
@@ -262,7 +296,13 @@ inline void RefreshModFolders(bool32 versionOnly = false, bool32 loadingBar = tr
     }
 }
 
-void RunModCallbacks(int32 callbackID, void *data);
+void RunModCallbackList(int32 callbackID, void *data);
+// called several times a frame, so the no subscribers case is kept down to a single test
+inline void RunModCallbacks(int32 callbackID, void *data)
+{
+    if ((uint32)callbackID < MODCB_MAX && (modCallbackMask & (1 << callbackID)))
+        RunModCallbackList(callbackID, data);
+}
 
 // Mod API
 #if RETRO_REV0U
@@ -26,6 +26,16 @@ RSDKContainer RSDK::dataPacks[DATAPACK_COUNT];
 uint8 RSDK::dataPackCount      = 0;
 uint16 RSDK::dataFileListCount = 0;
 
+#if !RETRO_USE_ORIGINAL_CODE
+HashIndexMD5<DATAFILE_COUNT * 2> RSDK::dataFileIndex;
+
+void RSDK::BuildDataFileIndex()
+{
+    dataFileIndex.Reset();
+    for (int32 f = 0; f < dataFileListCount; ++f) dataFileIndex.Add(dataFileList[f].hash, f);
+}
+#endif
+
 char RSDK::gameLogicName[0x200];
 
 bool32 RSDK::useDataPack = false;
@@ -172,6 +182,11 @@ bool32 RSDK::LoadDataPack(const char *filePath, size_t fileOffset, bool32 useBuf
         dataFileListCount += dataPacks[dataPackCount].fileCount;
         dataPackCount++;
 
+#if !RETRO_USE_ORIGINAL_CODE
+        // built up front so the first OpenDataFile call does not pay for it
+        BuildDataFileIndex();
+#endif
+
         CloseFile(&info);
 
         return true;
@@ -191,6 +206,74 @@ inline bool ends_with(std::string const &value, std::string const &ending)
 }
 #endif
 
+#if !RETRO_USE_ORIGINAL_CODE
+// OpenDataFile() minus the lookup & logging, the prefetch worker opens pack files through this
+static bool32 OpenDataFileEntry(FileInfo *info, RSDKFileInfo *file, const char *filename)
+{
+    info->usingFileBuffer = file->useFileBuffer;
+    if (!file->useFileBuffer) {
+        info->file = fOpen(dataPacks[file->packID].name, "rb");
+        if (!info->file)
+            return false;
+
+        fSeek(info->file, file->offset, SEEK_SET);
+    }
+    else {
+        // a bit of a hack, but it is how it is in the original
+        info->file = (FileIO *)&dataPacks[file->packID].fileBuffer[file->offset];
+
+        uint8 *fileBuffer = (uint8 *)info->file;
+        info->fileBuffer  = fileBuffer;
+    }
+
+    info->fileSize   = file->size;
+    info->readPos    = 0;
+    info->fileOffset = file->offset;
+    info->encrypted  = file->encrypted;
+    memset(info->encryptionKeyA, 0, 0x10 * sizeof(uint8));
+    memset(info->encryptionKeyB, 0, 0x10 * sizeof(uint8));
+    if (info->encrypted) {
+        GenerateELoadKeys(info, filename, info->fileSize);
+        info->eKeyNo      = (info->fileSize / 4) & 0x7F;
+        info->eKeyPosA    = 0;
+        info->eKeyPosB    = 8;
+        info->eNybbleSwap = false;
+    }
+
+    return true;
+}
+
+static int32 FindDataFile(const char *filename)
+{
+    char hashBuffer[0x400];
+    StringLowerCase(hashBuffer, filename);
+    RETRO_HASH_MD5(hash);
+    GEN_HASH_MD5_BUFFER(hashBuffer, hash);
+
+    if (!dataFileIndex.valid)
+        BuildDataFileIndex();
+
+    int32 f = dataFileIndex.Find(hash);
+    return f >= 0 && f < dataFileListCount ? f : -1;
+}
+
+bool32 RSDK::OpenDataFile(FileInfo *info, const char *filename)
+{
+    int32 f = FindDataFile(filename);
+    if (f >= 0) {
+        if (!OpenDataFileEntry(info, &dataFileList[f], filename)) {
+            PrintLog(PRINT_NORMAL, "File not found (Unable to open datapack): %s", filename);
+            return false;
+        }
+
+        PrintLog(PRINT_NORMAL, "Loaded data file %s", filename);
+        return true;
+    }
+
+    PrintLog(PRINT_NORMAL, "Data file not found: %s", filename);
+    return false;
+}
+#else
 bool32 RSDK::OpenDataFile(FileInfo *info, const char *filename)
 {
     char hashBuffer[0x400];
@@ -235,23 +318,256 @@ bool32 RSDK::OpenDataFile(FileInfo *info, const char *filename)
             info->eKeyPosB    = 8;
             info->eNybbleSwap = false;
         }
+        return true;
+    }
+
+    PrintLog(PRINT_NORMAL, "File not found: %s", filename);
+    return false;
+}
+#endif
 
 #if !RETRO_USE_ORIGINAL_CODE
-        PrintLog(PRINT_NORMAL, "Loaded data file %s", filename);
+enum PrefetchStates {
+    PREFETCH_QUEUED,
+    PREFETCH_READY,
+    PREFETCH_FAILED,
+};
+
+struct PrefetchFile {
+    char filePath[0x100]; // the path LoadFile() will be called with
+    char openPath[0x100]; // the full path the worker opens, resolved on the main thread since FindModFile() isn't thread-safe
+    int32 dataFileID;     // the dataFileList entry to read from instead, or -1
+    bool32 served;
+    uint8 *buffer;
+    int32 size;
+    uint64 readTicks;
+    ThreadAtomic state;
+};
+
+static PrefetchFile prefetchFiles[PREFETCH_FILE_COUNT];
+static int32 prefetchFileCount = 0;
+static PrefetchCallback prefetchCallback = NULL;
+static ThreadAtomic prefetchCancel;
+#if RETRO_USE_SDL_THREADS
+static SDL_Thread *prefetchThread = NULL;
+#else
+static std::thread prefetchThread;
 #endif
-        return true;
+
+// runs on the worker, so this only opens what PrefetchFiles() already resolved: no mod lookup, no case fallbacks & no logging
+// anything it can't open is left for LoadFile() to deal with on the main thread
+static bool32 OpenPrefetchFile(FileInfo *info, PrefetchFile *file)
+{
+    if (file->dataFileID >= 0)
+        return OpenDataFileEntry(info, &dataFileList[file->dataFileID], file->filePath);
+
+    if (!file->openPath[0])
+        return false;
+
+    info->file = fOpen(file->openPath, "rb");
+    if (!info->file)
+        return false;
+
+    fSeek(info->file, 0, SEEK_END);
+    info->fileSize = (int32)fTell(info->file);
+    fSeek(info->file, 0, SEEK_SET);
+    info->readPos = 0;
+    return true;
+}
+
+static int32 PrefetchWorker(void *data)
+{
+    // files are read in queue order, which is the order the scene loader asks for them in
+    for (int32 f = 0; f < prefetchFileCount; ++f) {
+        PrefetchFile *file = &prefetchFiles[f];
+
+        bool32 success = false;
+        if (!GetAtomic(prefetchCancel)) {
+            uint64 startTicks = GetProfilerTicks();
+
+            FileInfo info;
+            InitFileInfo(&info);
+            if (OpenPrefetchFile(&info, file)) {
+                if (info.fileSize > 0) {
+                    file->buffer = (uint8 *)malloc(info.fileSize);
+
+                    // ReadBytes() decrypts as it goes, so the staged copy is plain data
+                    if (file->buffer && ReadBytes(&info, file->buffer, info.fileSize) == (size_t)info.fileSize) {
+                        file->size = info.fileSize;
+                        success    = true;
+                    }
+                }
+
+                CloseFile(&info);
+            }
+
+            file->readTicks = GetProfilerTicks() - startTicks;
+
+            if (success && prefetchCallback)
+                prefetchCallback(file->filePath, file->buffer, file->size);
+        }
+
+        SetAtomic(file->state, success ? PREFETCH_READY : PREFETCH_FAILED);
     }
 
-#if !RETRO_USE_ORIGINAL_CODE
-    PrintLog(PRINT_NORMAL, "Data file not found: %s", filename);
+    return 0;
+}
+
+void RSDK::PrefetchFiles(const char **filePaths, int32 count, PrefetchCallback onRead)
+{
+    count = MIN(count, PREFETCH_FILE_COUNT);
+
+    // a batch without a callback is happy to reuse one that has one, but not the other way around, cancelled batches can't be reused at all
+    if (count == prefetchFileCount && (!onRead || onRead == prefetchCallback) && !GetAtomic(prefetchCancel)) {
+        int32 f = 0;
+        for (; f < count; ++f) {
+            if (strcmp(prefetchFiles[f].filePath, filePaths[f]) != 0)
+                break;
+        }
+
+        // already queued
+        if (f == count)
+            return;
+    }
+
+    ClearPrefetchedFiles();
+
+    if (!count)
+        return;
+
+    for (int32 f = 0; f < count; ++f) {
+        PrefetchFile *file = &prefetchFiles[f];
+
+        // the same lookups LoadFile() does, made here so the worker never has to
+        sprintf_s(file->filePath, sizeof(file->filePath), "%s", filePaths[f]);
+        file->openPath[0] = 0;
+        file->dataFileID  = -1;
+
+        const char *modFilePath = NULL;
+#if RETRO_USE_MOD_LOADER
+        modFilePath = FindModFile(filePaths[f]);
+#endif
+        if (modFilePath)
+            sprintf_s(file->openPath, sizeof(file->openPath), "%s", modFilePath);
+        else if (useDataPack)
+            file->dataFileID = FindDataFile(filePaths[f]);
+        else
+            sprintf_s(file->openPath, sizeof(file->openPath), "%s%s", SKU::userFileDir, filePaths[f]);
+
+        file->served    = false;
+        file->buffer    = NULL;
+        file->size      = 0;
+        file->readTicks = 0;
+        SetAtomic(file->state, PREFETCH_QUEUED);
+    }
+
+    prefetchFileCount = count;
+    prefetchCallback  = onRead;
+    SetAtomic(prefetchCancel, false);
+
+#if RETRO_USE_SDL_THREADS
+    prefetchThread = SDL_CreateThread((SDL_ThreadFunction)PrefetchWorker, "PrefetchFiles", NULL);
+    if (!prefetchThread) {
+        // no worker, let LoadFile() read them as usual
+        for (int32 f = 0; f < count; ++f) SetAtomic(prefetchFiles[f].state, PREFETCH_FAILED);
+    }
 #else
-    PrintLog(PRINT_NORMAL, "File not found: %s", filename);
+    prefetchThread = std::thread(PrefetchWorker, (void *)NULL);
+#endif
+}
+
+void RSDK::ClearPrefetchedFiles()
+{
+    if (!prefetchFileCount)
+        return;
+
+    SetAtomic(prefetchCancel, true);
+#if RETRO_USE_SDL_THREADS
+    if (prefetchThread) {
+        SDL_WaitThread(prefetchThread, NULL);
+        prefetchThread = NULL;
+    }
+#else
+    if (prefetchThread.joinable())
+        prefetchThread.join();
 #endif
+
+    for (int32 f = 0; f < prefetchFileCount; ++f) {
+        PrefetchFile *file = &prefetchFiles[f];
+
+        // time the worker spent off the main thread, reported alongside the (main thread) load breakdown
+        if (file->readTicks)
+            AddProfileTicks(PROFILE_PREFETCH_READ, file->readTicks);
+
+        if (!file->served)
+            AddProfileCount(PROFILE_PREFETCH_MISSES, 1);
+
+        free(file->buffer);
+        file->buffer = NULL;
+    }
+
+    prefetchFileCount = 0;
+}
+
+bool32 RSDK::CheckPrefetchBusy()
+{
+    // each file's state is the last thing the worker sets, so it's done once none are left queued
+    for (int32 f = 0; f < prefetchFileCount; ++f) {
+        if (GetAtomic(prefetchFiles[f].state) == PREFETCH_QUEUED)
+            return true;
+    }
+
     return false;
 }
 
+void RSDK::CancelPrefetchedFiles()
+{
+    if (prefetchFileCount)
+        SetAtomic(prefetchCancel, true);
+}
+
+static bool32 LoadPrefetchedFile(FileInfo *info, const char *filename)
+{
+    for (int32 f = 0; f < prefetchFileCount; ++f) {
+        PrefetchFile *file = &prefetchFiles[f];
+        if (strcmp(file->filePath, filename) != 0)
+            continue;
+
+        if (GetAtomic(file->state) == PREFETCH_QUEUED) {
+            BeginProfile(PROFILE_PREFETCH_WAIT);
+            while (GetAtomic(file->state) == PREFETCH_QUEUED) ThreadSleep();
+            EndProfile(PROFILE_PREFETCH_WAIT);
+        }
+
+        if (GetAtomic(file->state) != PREFETCH_READY)
+            return false;
+
+        // same setup OpenDataFile() uses for packs loaded into memory
+        info->usingFileBuffer = true;
+        info->file            = (FileIO *)file->buffer;
+        info->fileBuffer      = file->buffer;
+        info->fileSize        = file->size;
+        info->readPos         = 0;
+        info->fileOffset      = 0;
+        info->encrypted       = false;
+
+        file->served = true;
+        AddProfileCount(PROFILE_PREFETCH_HITS, 1);
+        PrintLog(PRINT_NORMAL, "Loaded prefetched file %s", filename);
+        return true;
+    }
+
+    return false;
+}
+#endif
+
 bool32 RSDK::LoadFile(FileInfo *info, const char *filename, uint8 fileMode)
 {
+#if !RETRO_USE_ORIGINAL_CODE
+    if (prefetchFileCount && !info->file && !info->externalFile && fileMode == FMODE_RB && LoadPrefetchedFile(info, filename))
+        return true;
+#endif
+
     RSDK::PrintLog(RSDK::PRINT_NORMAL, "[LoadFile] Attempting to load: '%s', Mode: %d, External: %d", filename, fileMode, info->externalFile);
     if (info->file)
         return false;
@@ -446,6 +762,142 @@ bool32 RSDK::LoadFile(FileInfo *info, const char *filename, uint8 fileMode)
     return true;
 }
 
+#if !RETRO_USE_ORIGINAL_CODE
+struct CookedHeader {
+    uint32 signature;
+    uint16 version;
+    uint8 type;
+    uint8 bigEndian; // blocks are raw engine memory, so they're only valid for the byte order they were cooked with
+    uint32 sourceSize;
+    uint32 sourceHash[4];
+    uint32 dataSize;
+};
+
+bool32 cookedAssetsWritable = true;
+
+bool32 RSDK::GenerateFileHashMD5(FileInfo *info, uint32 *hash)
+{
+    if (info->fileSize <= 0)
+        return false;
+
+    if (info->usingFileBuffer && !info->encrypted) {
+        GenerateHashMD5(hash, (char *)info->file, info->fileSize);
+    }
+    else {
+        uint8 *buffer = NULL;
+        AllocateStorage((void **)&buffer, info->fileSize, DATASET_TMP, false);
+        if (!buffer)
+            return false;
+
+        int32 readPos = info->readPos;
+        Seek_Set(info, 0);
+        ReadBytes(info, buffer, info->fileSize);
+        GenerateHashMD5(hash, (char *)buffer, info->fileSize);
+        Seek_Set(info, readPos);
+
+        RemoveStorageEntry((void **)&buffer);
+    }
+
+    return true;
+}
+
+bool32 RSDK::LoadCookedAsset(CookedAsset *asset, FileInfo *source, uint8 type)
+{
+    InitFileInfo(&asset->info);
+    asset->type        = type;
+    asset->sourceSize  = source->fileSize;
+    asset->filePath[0] = 0;
+
+    if (!GenerateFileHashMD5(source, asset->sourceHash))
+        return false;
+
+    return LoadCookedAssetByHash(asset, asset->sourceHash, source->fileSize, type);
+}
+
+bool32 RSDK::LoadCookedAssetByHash(CookedAsset *asset, const uint32 *sourceHash, int32 sourceSize, uint8 type)
+{
+    InitFileInfo(&asset->info);
+    asset->type       = type;
+    asset->sourceSize = sourceSize;
+    if (asset->sourceHash != sourceHash)
+        HASH_COPY_MD5(asset->sourceHash, sourceHash);
+
+    sprintf_s(asset->filePath, sizeof(asset->filePath), "%sCooked/%d%08X%08X%08X%08X.bin", SKU::userFileDir, type, sourceHash[0], sourceHash[1],
+              sourceHash[2], sourceHash[3]);
+
+    asset->info.file = fOpen(asset->filePath, "rb");
+    if (!asset->info.file)
+        return false;
+
+    fSeek(asset->info.file, 0, SEEK_END);
+    asset->info.fileSize = (int32)fTell(asset->info.file);
+    fSeek(asset->info.file, 0, SEEK_SET);
+
+    CookedHeader header;
+    memset(&header, 0, sizeof(header));
+    ReadBytes(&asset->info, &header, sizeof(header));
+
+    if (header.signature != COOKED_SIGNATURE || header.version != COOKED_VERSION || header.type != type || header.bigEndian != CheckBigEndian()
+        || header.sourceSize != (uint32)sourceSize || memcmp(header.sourceHash, sourceHash, sizeof(header.sourceHash)) != 0
+        || header.dataSize != (uint32)(asset->info.fileSize - sizeof(header))) {
+        PrintLog(PRINT_NORMAL, "Ignoring stale cooked asset %s", asset->filePath);
+        CloseCookedAsset(asset);
+        return false;
+    }
+
+    AddProfileCount(PROFILE_COOKED_HITS, 1);
+    return true;
+}
+
+void RSDK::ReadCookedBlock(CookedAsset *asset, void *data, int32 size)
+{
+    ReadBytes(&asset->info, data, size);
+
+    // blocks are kept 16-byte aligned
+    if (size & 0xF)
+        Seek_Cur(&asset->info, 0x10 - (size & 0xF));
+}
+
+void RSDK::CloseCookedAsset(CookedAsset *asset) { CloseFile(&asset->info); }
+
+void RSDK::SaveCookedAsset(CookedAsset *asset, void **blocks, int32 *blockSizes, int32 blockCount)
+{
+    if (!cookedAssetsWritable || !asset->filePath[0])
+        return;
+
+    FileIO *file = fOpen(asset->filePath, "wb");
+    if (!file) {
+        // most likely there's no Cooked folder, don't bother trying again this session
+        PrintLog(PRINT_NORMAL, "Unable to write cooked asset %s, cooking disabled", asset->filePath);
+        cookedAssetsWritable = false;
+        return;
+    }
+
+    CookedHeader header;
+    memset(&header, 0, sizeof(header));
+    header.signature = COOKED_SIGNATURE;
+    header.version   = COOKED_VERSION;
+    header.type       = asset->type;
+    header.bigEndian  = CheckBigEndian();
+    header.sourceSize = asset->sourceSize;
+    memcpy(header.sourceHash, asset->sourceHash, sizeof(header.sourceHash));
+    for (int32 b = 0; b < blockCount; ++b) header.dataSize += (blockSizes[b] + 0xF) & ~0xF;
+
+    fWrite(&header, 1, sizeof(header), file);
+
+    uint8 padding[0x10];
+    memset(padding, 0, sizeof(padding));
+    for (int32 b = 0; b < blockCount; ++b) {
+        fWrite(blocks[b], 1, blockSizes[b], file);
+        if (blockSizes[b] & 0xF)
+            fWrite(padding, 1, 0x10 - (blockSizes[b] & 0xF), file);
+    }
+
+    fClose(file);
+    AddProfileCount(PROFILE_COOKED_WRITES, 1);
+}
+#endif
+
 void RSDK::GenerateELoadKeys(FileInfo *info, const char *key1, int32 key2)
 {
     // This function splits hashes into bytes by casting their integers to byte arrays,
@@ -579,3 +1031,129 @@ void RSDK::SkipBytes(FileInfo *info, int32 size)
         }
     }
 }
+
+#if !RETRO_USE_ORIGINAL_CODE
+void RSDK::SwapArrayEndian16(void *buffer, int32 count)
+{
+    uint8 *data = (uint8 *)buffer;
+
+#if RETRO_USE_ALTIVEC
+    if (!((size_t)data & 1)) {
+        // one at a time up to a 16 byte boundary, then 8 values per vperm
+        for (; count > 0 && ((size_t)data & 0xF); --count, data += sizeof(uint16)) {
+            uint8 store = data[0];
+            data[0]     = data[1];
+            data[1]     = store;
+        }
+
+        const __vector unsigned char swapMask = { 1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14 };
+        for (; count >= 8; count -= 8, data += 0x10) {
+            __vector unsigned char values = vec_ld(0, data);
+            vec_st(vec_perm(values, values, swapMask), 0, data);
+        }
+    }
+#endif
+
+    for (; count > 0; --count, data += sizeof(uint16)) {
+        uint8 store = data[0];
+        data[0]     = data[1];
+        data[1]     = store;
+    }
+}
+
+void RSDK::SwapArrayEndian32(void *buffer, int32 count)
+{
+    uint8 *data = (uint8 *)buffer;
+
+#if RETRO_USE_ALTIVEC
+    if (!((size_t)data & 3)) {
+        // one at a time up to a 16 byte boundary, then 4 values per vperm
+        for (; count > 0 && ((size_t)data & 0xF); --count, data += sizeof(uint32)) {
+            uint32 value = 0;
+            memcpy(&value, data, sizeof(uint32));
+            value = (value << 24) | ((value << 8) & 0x00FF0000) | ((value >> 8) & 0x0000FF00) | (value >> 24);
+            memcpy(data, &value, sizeof(uint32));
+        }
+
+        const __vector unsigned char swapMask = { 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12 };
+        for (; count >= 4; count -= 4, data += 0x10) {
+            __vector unsigned char values = vec_ld(0, data);
+            vec_st(vec_perm(values, values, swapMask), 0, data);
+        }
+    }
+#endif
+
+    for (; count > 0; --count, data += sizeof(uint32)) {
+        uint32 value = 0;
+        memcpy(&value, data, sizeof(uint32));
+        value = (value << 24) | ((value << 8) & 0x00FF0000) | ((value >> 8) & 0x0000FF00) | (value >> 24);
+        memcpy(data, &value, sizeof(uint32));
+    }
+}
+#endif
+
+#if !RETRO_USE_ORIGINAL_CODE
+// ReadCompressed is only ever called from the main thread, so one inflator does
+tinfl_decompressor compressedInflator;
+
+int32 InflateCompressedBlock(FileInfo *info, int32 cSize, uint8 *buffer, int32 size)
+{
+    int32 endPos  = MIN(info->readPos + cSize, info->fileSize);
+    size_t outPos = 0;
+
+    if (buffer && size > 0) {
+        tinfl_init(&compressedInflator);
+        uint32 flags = TINFL_FLAG_PARSE_ZLIB_HEADER | TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF;
+
+        if (info->usingFileBuffer && !info->encrypted) {
+            size_t inSize  = endPos - info->readPos;
+            size_t outSize = size;
+            tinfl_decompress(&compressedInflator, info->fileBuffer, &inSize, buffer, buffer, &outSize, flags);
+            outPos = outSize;
+        }
+        else {
+            uint8 chunk[0x1000];
+
+            tinfl_status status = TINFL_STATUS_NEEDS_MORE_INPUT;
+            while (status == TINFL_STATUS_NEEDS_MORE_INPUT && info->readPos < endPos) {
+                size_t inSize = ReadBytes(info, chunk, MIN((int32)sizeof(chunk), endPos - info->readPos));
+                if (!inSize)
+                    break;
+
+                size_t outSize = size - outPos;
+                status         = tinfl_decompress(&compressedInflator, chunk, &inSize, buffer, buffer + outPos, &outSize,
+                                                  flags | (info->readPos < endPos ? TINFL_FLAG_HAS_MORE_INPUT : 0));
+                outPos += outSize;
+            }
+        }
+    }
+
+    // skip past anything that wasn't read, be it the whole block or whatever didn't fit
+    if (info->readPos < endPos)
+        Seek_Cur(info, endPos - info->readPos);
+
+    return (int32)outPos;
+}
+
+int32 RSDK::ReadCompressed(FileInfo *info, uint8 **buffer)
+{
+    if (!buffer)
+        return 0;
+
+    uint32 cSize  = ReadInt32(info, false) - 4;
+    uint32 sizeBE = ReadInt32(info, false);
+
+    uint32 sizeLE = (uint32)((sizeBE << 24) | ((sizeBE << 8) & 0x00FF0000) | ((sizeBE >> 8) & 0x0000FF00) | (sizeBE >> 24));
+    AllocateStorage((void **)buffer, sizeLE, DATASET_TMP, false);
+
+    return InflateCompressedBlock(info, cSize, *buffer, sizeLE);
+}
+
+int32 RSDK::ReadCompressedInto(FileInfo *info, void *buffer, int32 size)
+{
+    uint32 cSize = ReadInt32(info, false) - 4;
+    ReadInt32(info, false); // decompressed size, the caller's storage decides how much we take
+
+    return InflateCompressedBlock(info, cSize, (uint8 *)buffer, size);
+}
+#endif
@@ -80,6 +80,11 @@ extern RSDKContainer dataPacks[DATAPACK_COUNT];
 
 extern uint8 dataPackCount;
 extern uint16 dataFileListCount;
+#if !RETRO_USE_ORIGINAL_CODE
+extern HashIndexMD5<DATAFILE_COUNT * 2> dataFileIndex;
+
+void BuildDataFileIndex();
+#endif
 
 extern char gameLogicName[0x200];
 
@@ -119,6 +124,57 @@ inline void InitFileInfo(FileInfo *info)
 
 bool32 LoadFile(FileInfo *info, const char *filename, uint8 fileMode);
 
+#if !RETRO_USE_ORIGINAL_CODE
+#define PREFETCH_FILE_COUNT (8)
+
+// Reads the given files into staging buffers on a background thread, LoadFile() then serves them from memory
+// the previous batch (if any) is cancelled & released first
+// onRead (if set) is called on the worker with each file's contents before LoadFile() is allowed to use them
+typedef void (*PrefetchCallback)(const char *filePath, uint8 *buffer, int32 size);
+void PrefetchFiles(const char **filePaths, int32 count, PrefetchCallback onRead = NULL);
+// waits for the worker, then releases the batch
+void ClearPrefetchedFiles();
+// true while the worker still has files to get through, once it's false ClearPrefetchedFiles() won't have to wait
+bool32 CheckPrefetchBusy();
+// tells the worker to skip the rest of the batch without waiting for it, anything not read yet falls back to LoadFile()'s usual path
+void CancelPrefetchedFiles();
+
+// Cooked assets are the decoded forms of stage assets (tileset planes, collision masks, layer layouts), the game registry & mod folder listings,
+// stored raw in "Cooked/" in the user file dir
+// they're named after the MD5 of the source file's contents, so an edited or modded source never picks up a stale copy
+// nothing gets cooked unless that folder exists, run with "cook=true" to cook every scene in one go
+#define COOKED_SIGNATURE (0x444B4F43) // "COKD"
+#define COOKED_VERSION   (1)
+
+enum CookedAssetTypes {
+    COOKED_TILESET,
+    COOKED_TILECONFIG,
+    COOKED_SCENE,
+    COOKED_REGISTRY,
+    COOKED_MODFILES,
+};
+
+struct CookedAsset {
+    FileInfo info;
+    uint8 type;
+    int32 sourceSize;
+    RETRO_HASH_MD5(sourceHash);
+    char filePath[0x100 + 0x30]; // userFileDir, then "Cooked/", the type & the hash
+};
+
+// MD5 of the file's entire contents, the read position is left where it was
+bool32 GenerateFileHashMD5(FileInfo *info, uint32 *hash);
+
+// opens the cooked form of source (rewinding source after hashing it), false if there isn't a usable one
+bool32 LoadCookedAsset(CookedAsset *asset, FileInfo *source, uint8 type);
+// same as above, for assets built from more than one source file, sourceHash should cover all of them
+bool32 LoadCookedAssetByHash(CookedAsset *asset, const uint32 *sourceHash, int32 sourceSize, uint8 type);
+void ReadCookedBlock(CookedAsset *asset, void *data, int32 size);
+void CloseCookedAsset(CookedAsset *asset);
+// writes the cooked form, asset must've been passed through LoadCookedAsset() first
+void SaveCookedAsset(CookedAsset *asset, void **blocks, int32 *blockSizes, int32 blockCount);
+#endif
+
 inline void CloseFile(FileInfo *info)
 {
     if (!info->usingFileBuffer && info->file)
@@ -130,6 +186,11 @@ inline void CloseFile(FileInfo *info)
 void GenerateELoadKeys(FileInfo *info, const char *key1, int32 key2);
 void DecryptBytes(FileInfo *info, void *buffer, size_t size);
 void SkipBytes(FileInfo *info, int32 size);
+#if !RETRO_USE_ORIGINAL_CODE
+// Reverses the byte order of count 16/32-bit values in place
+void SwapArrayEndian16(void *buffer, int32 count);
+void SwapArrayEndian32(void *buffer, int32 count);
+#endif
 
 inline void Seek_Set(FileInfo *info, int32 count)
 {
@@ -406,6 +467,48 @@ inline void ReadString(FileInfo *info, char *buffer)
     buffer[size] = 0;
 }
 
+#if !RETRO_USE_ORIGINAL_CODE
+// Array versions of ReadInt16/ReadInt32/ReadSingle: the whole array is pulled in with a single read, then swapped in place on big endian machines
+// they return how many values were read in full
+inline int32 ReadArrayInt16(FileInfo *info, int16 *buffer, int32 count)
+{
+    int32 readCount = (int32)(ReadBytes(info, buffer, count * sizeof(int16)) / sizeof(int16));
+    if (CheckBigEndian())
+        SwapArrayEndian16(buffer, readCount);
+
+    return readCount;
+}
+
+inline int32 ReadArrayInt32(FileInfo *info, int32 *buffer, int32 count)
+{
+    int32 readCount = (int32)(ReadBytes(info, buffer, count * sizeof(int32)) / sizeof(int32));
+    if (CheckBigEndian())
+        SwapArrayEndian32(buffer, readCount);
+
+    return readCount;
+}
+
+inline int32 ReadArrayFloat(FileInfo *info, float *buffer, int32 count)
+{
+    int32 readCount = (int32)(ReadBytes(info, buffer, count * sizeof(float)) / sizeof(float));
+    if (CheckBigEndian())
+        SwapArrayEndian32(buffer, readCount);
+
+    return readCount;
+}
+
+// For records that mix value sizes: read the whole block with ReadBytes, then pull the little endian values out of it with these
+inline int16 GetInt16LE(const uint8 *data) { return (int16)(data[0] | (data[1] << 8)); }
+inline int32 GetInt32LE(const uint8 *data) { return (int32)(data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32)data[3] << 24)); }
+inline float GetSingleLE(const uint8 *data)
+{
+    int32 value  = GetInt32LE(data);
+    float result = 0;
+    memcpy(&result, &value, sizeof(float));
+    return result;
+}
+#endif
+
 inline int32 Uncompress(uint8 **cBuffer, int32 cSize, uint8 **buffer, int32 size)
 {
     if (!buffer || !cBuffer)
@@ -420,6 +523,13 @@ inline int32 Uncompress(uint8 **cBuffer, int32 cSize, uint8 **buffer, int32 size
     return (int32)destLen;
 }
 
+#if !RETRO_USE_ORIGINAL_CODE
+// Compressed blocks are inflated straight from the file (or from memory, if it's already there), the compressed bytes never get a TMP copy of their own
+// The buffer passed in parameter is allocated here, so it's up to the caller to free it once it goes unused
+int32 ReadCompressed(FileInfo *info, uint8 **buffer);
+// Same as above, but inflates into storage the caller already has, anything beyond size is skipped
+int32 ReadCompressedInto(FileInfo *info, void *buffer, int32 size);
+#else
 // The buffer passed in parameter is allocated here, so it's up to the caller to free it once it goes unused
 inline int32 ReadCompressed(FileInfo *info, uint8 **buffer)
 {
@@ -441,6 +551,7 @@ inline int32 ReadCompressed(FileInfo *info, uint8 **buffer)
 
     return newSize;
 }
+#endif
 
 inline void ClearDataFiles()
 {
@@ -448,6 +559,10 @@ inline void ClearDataFiles()
     for (int32 f = 0; f < DATAFILE_COUNT; ++f) {
         HASH_CLEAR_MD5(dataFileList[f].hash);
     }
+
+#if !RETRO_USE_ORIGINAL_CODE
+    dataFileIndex.Invalidate();
+#endif
 }
 
 } // namespace RSDK
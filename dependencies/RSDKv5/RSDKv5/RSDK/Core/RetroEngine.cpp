@@ -16,14 +16,53 @@ Link::Handle gameLogicHandle = NULL;
 #endif
 
 int32 *RSDK::globalVarsPtr = NULL;
+#if !RETRO_USE_ORIGINAL_CODE
+int32 RSDK::globalVarsSize = 0;
+#endif
 #if RETRO_REV0U
 void (*RSDK::globalVarsInitCB)(void *globals) = NULL;
 #endif
 
 RetroEngine RSDK::engine = RetroEngine();
 
+#if !RETRO_USE_ORIGINAL_CODE
+uint64 fixedStepPrevTicks   = 0;
+uint64 fixedStepAccumulated = 0; // elapsed ticks * 60, so a whole step is exactly GetProfilerFrequency()
+
+// the game's meant to run at 60hz, but CheckFPSCap() paces the loop to videoSettings.refreshRate
+// so above that, only the presents that a 60hz step has come due for get to run the engine
+bool32 CheckFixedStep()
+{
+    // at 60hz (or lower, where a present can't fit more than one step anyways) every present is a step, like always
+    if (videoSettings.refreshRate <= 60) {
+        fixedStepPrevTicks = 0;
+        return true;
+    }
+
+    uint64 ticks     = GetProfilerTicks();
+    uint64 frequency = GetProfilerFrequency();
+    if (fixedStepPrevTicks)
+        fixedStepAccumulated += (ticks - fixedStepPrevTicks) * 60;
+    else
+        fixedStepAccumulated = frequency;
+    fixedStepPrevTicks = ticks;
+
+    if (fixedStepAccumulated < frequency)
+        return false;
+
+    // after a hitch, only one step gets made up for, the rest is dropped so the game slows down instead of rushing to catch up
+    fixedStepAccumulated = MIN(fixedStepAccumulated - frequency, frequency);
+    return true;
+}
+#endif
+
 int32 RSDK::RunRetroEngine(int32 argc, char *argv[])
 {
+#if !RETRO_USE_ORIGINAL_CODE
+    // reported once the first frame's been presented
+    uint64 bootTicks = GetProfilerTicks();
+#endif
+
     ParseArguments(argc, argv);
 
     if (engine.consoleEnabled)
@@ -103,6 +142,18 @@ int32 RSDK::RunRetroEngine(int32 argc, char *argv[])
             SendQuitMsg();
         }
 #endif
+
+#if !RETRO_USE_ORIGINAL_CODE
+#if RETRO_REV0U
+        if (engine.cookAssets && engine.version == 5) {
+#else
+        if (engine.cookAssets) {
+#endif
+            ResetProfiler();
+            CookSceneAssets();
+            RenderDevice::isRunning = false;
+        }
+#endif
     }
 
     RenderDevice::InitFPSCap();
@@ -116,6 +167,17 @@ int32 RSDK::RunRetroEngine(int32 argc, char *argv[])
         if (RenderDevice::CheckFPSCap()) {
             RenderDevice::UpdateFPSCap();
 
+#if !RETRO_USE_ORIGINAL_CODE
+            if (!CheckFixedStep()) {
+                // nothing's changed since the last present, so it's the same frame again
+                if (videoSettings.windowState == WINDOWSTATE_ACTIVE) {
+                    AddProfileCount(PROFILE_REPEAT_PRESENT, 1);
+                    RenderDevice::FlipScreen();
+                }
+                continue;
+            }
+#endif
+
             AudioDevice::FrameInit();
 
 #if RETRO_REV02
@@ -192,6 +254,8 @@ int32 RSDK::RunRetroEngine(int32 argc, char *argv[])
 #if RETRO_REV02
                         forceHardReset = true;
 #endif
+                        // mods can replace any sfx, so nothing decoded so far can be trusted
+                        ClearSfxCache();
 
 #if RETRO_REV0U
                         int32 preVersion = engine.version;
@@ -210,6 +274,9 @@ int32 RSDK::RunRetroEngine(int32 argc, char *argv[])
 
                         globalVarsPtr    = NULL;
                         globalVarsInitCB = NULL;
+#if !RETRO_USE_ORIGINAL_CODE
+                        globalVarsSize = 0;
+#endif
 
                         dataStorage[DATASET_STG].entryCount  = 0;
                         dataStorage[DATASET_STG].usedStorage = 0;
@@ -261,6 +328,11 @@ int32 RSDK::RunRetroEngine(int32 argc, char *argv[])
                     if (engine.devMenu)
                         ProcessDebugCommands();
 
+#if !RETRO_USE_ORIGINAL_CODE
+                    ++profiler.frameCount;
+                    SyncProfiler();
+#endif
+
 #if RETRO_REV0U
                     switch (engine.version) {
                         default:
@@ -318,11 +390,23 @@ int32 RSDK::RunRetroEngine(int32 argc, char *argv[])
                 // RenderDevice::ProcessDimming();
 
             RenderDevice::FlipScreen();
+
+#if !RETRO_USE_ORIGINAL_CODE
+            if (bootTicks) {
+                PrintLog(PRINT_NORMAL, "Time to first frame: %.2fms", (GetProfilerTicks() - bootTicks) * 1000.0 / GetProfilerFrequency());
+                bootTicks = 0;
+            }
+#endif
         }
     }
 
     // Shutdown
 
+#if !RETRO_USE_ORIGINAL_CODE
+    ClearPrefetchedFiles();
+    ClearStagedScene();
+    ReleaseIsolatedUpdates();
+#endif
     ReleaseInputDevices();
     AudioDevice::Release();
     RenderDevice::Release(false);
@@ -353,12 +437,50 @@ void RSDK::ProcessEngine()
             }
             else {
 #if RETRO_USE_MOD_LOADER
-                if (devMenu.modsChanged)
+                if (devMenu.modsChanged) {
+#if !RETRO_USE_ORIGINAL_CODE
+                    // anything staged may have come from a mod that's no longer active
+                    ClearPrefetchedFiles();
+                    ClearStagedScene();
+#endif
                     RefreshModFolders();
+                }
 #endif
+#if !RETRO_USE_ORIGINAL_CODE
+                ResetProfiler();
+                BeginProfile(PROFILE_SCENE_LOAD);
+
+                // no-op if SetScene() already queued this scene
+                PrefetchScene();
+
+                BeginProfile(PROFILE_LOAD_FOLDER);
                 LoadSceneFolder();
+                EndProfile(PROFILE_LOAD_FOLDER);
+
+                BeginProfile(PROFILE_LOAD_SCENE);
                 LoadSceneAssets();
+                EndProfile(PROFILE_LOAD_SCENE);
+
+                BeginProfile(PROFILE_LOAD_OBJECTS);
+                BeginSpriteDecodes();
                 InitObjects();
+                WaitForSpriteDecodes();
+                EndProfile(PROFILE_LOAD_OBJECTS);
+
+                ClearPrefetchedFiles();
+                // a preloaded scene that wasn't the one just loaded won't be used now
+                ClearStagedScene();
+#else
+                LoadSceneFolder();
+                LoadSceneAssets();
+                InitObjects();
+#endif
+#if !RETRO_USE_ORIGINAL_CODE
+                EndProfile(PROFILE_SCENE_LOAD);
+                // like the profiler menu, the report's only there with the dev menu enabled
+                if (engine.devMenu)
+                    PrintProfilerReport();
+#endif
 
 #if RETRO_REV02
 #if !RETRO_USE_ORIGINAL_CODE
@@ -384,6 +506,9 @@ void RSDK::ProcessEngine()
             break;
 
         case ENGINESTATE_REGULAR:
+#if !RETRO_USE_ORIGINAL_CODE
+            ProcessScenePreload();
+#endif
             ProcessInput();
             ProcessSceneTimer();
             ProcessObjects();
@@ -441,12 +566,47 @@ void RSDK::ProcessEngine()
 
         case ENGINESTATE_LOAD | ENGINESTATE_STEPOVER:
 #if RETRO_USE_MOD_LOADER
-            if (devMenu.modsChanged)
+            if (devMenu.modsChanged) {
+#if !RETRO_USE_ORIGINAL_CODE
+                ClearPrefetchedFiles();
+                ClearStagedScene();
+#endif
                 RefreshModFolders();
+            }
 #endif
+#if !RETRO_USE_ORIGINAL_CODE
+            ResetProfiler();
+            BeginProfile(PROFILE_SCENE_LOAD);
+
+            PrefetchScene();
+
+            BeginProfile(PROFILE_LOAD_FOLDER);
             LoadSceneFolder();
+            EndProfile(PROFILE_LOAD_FOLDER);
+
+            BeginProfile(PROFILE_LOAD_SCENE);
             LoadSceneAssets();
+            EndProfile(PROFILE_LOAD_SCENE);
+
+            BeginProfile(PROFILE_LOAD_OBJECTS);
+            BeginSpriteDecodes();
             InitObjects();
+            WaitForSpriteDecodes();
+            EndProfile(PROFILE_LOAD_OBJECTS);
+
+            ClearPrefetchedFiles();
+            // a preloaded scene that wasn't the one just loaded won't be used now
+            ClearStagedScene();
+#else
+            LoadSceneFolder();
+            LoadSceneAssets();
+            InitObjects();
+#endif
+#if !RETRO_USE_ORIGINAL_CODE
+            EndProfile(PROFILE_SCENE_LOAD);
+            if (engine.devMenu)
+                PrintProfilerReport();
+#endif
 
 #if RETRO_REV02
 #if !RETRO_USE_ORIGINAL_CODE
@@ -628,6 +788,24 @@ void RSDK::ParseArguments(int32 argc, char *argv[])
             engine.consoleEnabled = true;
             engine.devMenu        = true;
         }
+
+#if !RETRO_USE_ORIGINAL_CODE
+        find = strstr(argv[a], "cook=true");
+        if (find)
+            engine.cookAssets = true;
+
+        find = strstr(argv[a], "decodethreads=");
+        if (find)
+            engine.spriteDecodeThreads = CLAMP(atoi(&find[14]), 0, SPRITEDECODE_THREAD_COUNT);
+
+        find = strstr(argv[a], "updatethreads=");
+        if (find)
+            engine.updateThreads = CLAMP(atoi(&find[14]), 0, UPDATE_THREAD_COUNT);
+
+        find = strstr(argv[a], "checkisolated=true");
+        if (find)
+            engine.checkIsolated = true;
+#endif
     }
 }
 
@@ -745,6 +923,10 @@ void RSDK::StartGameObjects()
 #else
     memset(&objectClassList, 0, sizeof(objectClassList));
 #endif
+#if !RETRO_USE_ORIGINAL_CODE
+    objectClassIndex.Invalidate();
+    stageObjectIndex.Invalidate();
+#endif
 
     sceneInfo.classCount     = 0;
     sceneInfo.activeCategory = 0;
@@ -762,8 +944,56 @@ void RSDK::StartGameObjects()
 }
 
 #if RETRO_USE_MOD_LOADER
+#if !RETRO_USE_ORIGINAL_CODE
+struct XMLSfxEntry {
+    char path[0x80];
+    int32 maxConcurrentPlays;
+};
+
+struct XMLPaletteEntry {
+    uint8 bankID;
+    uint8 index;
+    uint32 color;
+};
+
+// what the active mods' Game.xml files add on top of GameConfig.bin, recorded while they're parsed so the game registry can be cooked
+static char xmlGameTitle[0x40];
+static std::vector<uint32> xmlObjectHashes; // 4 per object
+static std::vector<XMLSfxEntry> xmlSfxList;
+static std::vector<XMLPaletteEntry> xmlPaletteList;
+// the palettes are applied on every scene load, once they've been recorded there's no need to parse anything again
+static bool32 xmlPalettesLoaded     = false;
+static bool32 recordXMLPalettesOnly = false;
+
+static void AddXMLPaletteEntry(int32 bankID, int32 index, uint32 color)
+{
+    if (!recordXMLPalettesOnly)
+        SetPaletteEntry(bankID, index, color);
+
+    XMLPaletteEntry entry;
+    entry.bankID = bankID;
+    entry.index  = index;
+    entry.color  = color;
+    xmlPaletteList.push_back(entry);
+}
+#endif
+
 void RSDK::LoadGameXML(bool pal)
 {
+#if !RETRO_USE_ORIGINAL_CODE
+    if (pal && xmlPalettesLoaded) {
+        for (size_t p = 0; p < xmlPaletteList.size(); ++p) SetPaletteEntry(xmlPaletteList[p].bankID, xmlPaletteList[p].index, xmlPaletteList[p].color);
+        return;
+    }
+
+    xmlPaletteList.clear();
+    if (!pal) {
+        xmlGameTitle[0] = 0;
+        xmlObjectHashes.clear();
+        xmlSfxList.clear();
+    }
+#endif
+
     FileInfo info;
     SortMods();
     for (int32 m = 0; m < modList.size(); ++m) {
@@ -790,6 +1020,12 @@ void RSDK::LoadGameXML(bool pal)
                     LoadXMLObjects(gameElement);
                     LoadXMLSoundFX(gameElement);
                     LoadXMLStages(gameElement);
+#if !RETRO_USE_ORIGINAL_CODE
+                    // grab the palettes too while the document's parsed
+                    recordXMLPalettesOnly = true;
+                    LoadXMLPalettes(gameElement);
+                    recordXMLPalettesOnly = false;
+#endif
                 }
             }
             else {
@@ -801,6 +1037,10 @@ void RSDK::LoadGameXML(bool pal)
         }
     }
     SetActiveMod(-1);
+
+#if !RETRO_USE_ORIGINAL_CODE
+    xmlPalettesLoaded = true;
+#endif
 }
 
 void RSDK::LoadXMLWindowText(const tinyxml2::XMLElement *gameElement)
@@ -808,8 +1048,12 @@ void RSDK::LoadXMLWindowText(const tinyxml2::XMLElement *gameElement)
     const tinyxml2::XMLElement *titleElement = gameElement->FirstChildElement("title");
     if (titleElement) {
         const tinyxml2::XMLAttribute *nameAttr = titleElement->FindAttribute("name");
-        if (nameAttr)
+        if (nameAttr) {
             strcpy(gameVerInfo.gameTitle, nameAttr->Value());
+#if !RETRO_USE_ORIGINAL_CODE
+            sprintf_s(xmlGameTitle, sizeof(xmlGameTitle), "%s", gameVerInfo.gameTitle);
+#endif
+        }
     }
 }
 
@@ -844,7 +1088,11 @@ void RSDK::LoadXMLPalettes(const tinyxml2::XMLElement *gameElement)
             if (bAttr)
                 b = bAttr->IntValue();
 
+#if !RETRO_USE_ORIGINAL_CODE
+            AddXMLPaletteEntry(bank, index, (r << 16) | (g << 8) | b);
+#else
             SetPaletteEntry(bank, index, (r << 16) | (g << 8) | b);
+#endif
         }
 
         for (const tinyxml2::XMLElement *clrsElement = paletteElement->FirstChildElement("colors"); clrsElement;
@@ -878,7 +1126,11 @@ void RSDK::LoadXMLPalettes(const tinyxml2::XMLElement *gameElement)
                     color   = (r << 16) | (g << 8) | b;
                 }
 
+#if !RETRO_USE_ORIGINAL_CODE
+                AddXMLPaletteEntry(bank, index++, color);
+#else
                 SetPaletteEntry(bank, index++, color);
+#endif
                 text = match.suffix();
             }
         }
@@ -898,6 +1150,9 @@ void RSDK::LoadXMLObjects(const tinyxml2::XMLElement *gameElement)
 
             RETRO_HASH_MD5(hash);
             GEN_HASH_MD5(objName, hash);
+#if !RETRO_USE_ORIGINAL_CODE
+            xmlObjectHashes.insert(xmlObjectHashes.end(), hash, hash + 4);
+#endif
             globalObjectIDs[globalObjectCount] = 0;
             for (int32 objID = 0; objID < objectClassCount; ++objID) {
                 if (HASH_MATCH_MD5(hash, objectClassList[objID].hash)) {
@@ -925,6 +1180,13 @@ void RSDK::LoadXMLSoundFX(const tinyxml2::XMLElement *gameElement)
             if (playsAttr)
                 maxConcurrentPlays = playsAttr->IntValue();
 
+#if !RETRO_USE_ORIGINAL_CODE
+            XMLSfxEntry entry;
+            sprintf_s(entry.path, sizeof(entry.path), "%s", sfxPath);
+            entry.maxConcurrentPlays = maxConcurrentPlays;
+            xmlSfxList.push_back(entry);
+#endif
+
             LoadSfx((char *)sfxPath, maxConcurrentPlays, SCOPE_GLOBAL);
         }
     }
@@ -1012,8 +1274,129 @@ void RSDK::LoadXMLStages(const tinyxml2::XMLElement *gameElement)
     }
     sceneInfo.listData     = listData.data();
     sceneInfo.listCategory = listCategory.data();
+#if !RETRO_USE_ORIGINAL_CODE
+    sceneListIndex.Invalidate();
+#endif
+}
+
+#if !RETRO_USE_ORIGINAL_CODE
+// the game registry is everything LoadGameConfig() builds from GameConfig.bin & the active mods' Game.xml files
+// it's cooked under a hash of all of their contents (in load order), so it goes stale as soon as any of them change
+struct GameRegistryHeader {
+    int32 categoryCount;
+    int32 listCategorySize;
+    int32 listDataSize;
+    int32 varOffset; // where the global variables start in GameConfig.bin
+    int32 objectCount;
+    int32 sfxCount;
+    int32 paletteCount;
+    char gameTitle[0x40];
+};
+
+static bool32 LoadGameRegistry(CookedAsset *registry, FileInfo *gameConfig)
+{
+    std::vector<uint32> hashes(4);
+    if (!GenerateFileHashMD5(gameConfig, &hashes[0]))
+        return false;
+    int32 sourceSize = gameConfig->fileSize;
+
+    // the same files LoadGameXML() would parse
+    FileInfo info;
+    SortMods();
+    for (int32 m = 0; m < modList.size(); ++m) {
+        if (!modList[m].active)
+            break;
+        SetActiveMod(m);
+        InitFileInfo(&info);
+        if (LoadFile(&info, "Data/Game/Game.xml", FMODE_RB)) {
+            hashes.resize(hashes.size() + 4);
+            GenerateFileHashMD5(&info, &hashes[hashes.size() - 4]);
+            sourceSize += info.fileSize;
+            CloseFile(&info);
+        }
+    }
+    SetActiveMod(-1);
+
+    // the blocks are raw structs, so builds that lay them out differently can't share a registry
+    hashes.push_back(RETRO_REVISION);
+    hashes.push_back(sizeof(SceneListInfo));
+    hashes.push_back(sizeof(SceneListEntry));
+    hashes.push_back(sizeof(GameRegistryHeader));
+
+    RETRO_HASH_MD5(registryHash);
+    GenerateHashMD5(registryHash, (char *)hashes.data(), (int32)(hashes.size() * sizeof(uint32)));
+    return LoadCookedAssetByHash(registry, registryHash, sourceSize, COOKED_REGISTRY);
+}
+
+// reads the scene list in, the rest is applied by ApplyGameRegistry() once GameConfig.bin's been read through
+static void ReadGameRegistry(CookedAsset *registry, GameRegistryHeader *header)
+{
+    ReadCookedBlock(registry, header, sizeof(GameRegistryHeader));
+
+    listCategory.resize(header->listCategorySize);
+    ReadCookedBlock(registry, listCategory.data(), header->listCategorySize * sizeof(SceneListInfo));
+    listData.resize(header->listDataSize);
+    ReadCookedBlock(registry, listData.data(), header->listDataSize * sizeof(SceneListEntry));
+
+    sceneInfo.categoryCount = header->categoryCount;
+    sceneInfo.listCategory  = listCategory.data();
+    sceneInfo.listData      = listData.data();
+}
+
+// does what LoadGameXML() would, without any parsing
+static void ApplyGameRegistry(CookedAsset *registry, GameRegistryHeader *header)
+{
+    if (header->gameTitle[0])
+        strcpy(gameVerInfo.gameTitle, header->gameTitle);
+    sprintf_s(xmlGameTitle, sizeof(xmlGameTitle), "%s", header->gameTitle);
+
+    xmlObjectHashes.resize(header->objectCount * 4);
+    ReadCookedBlock(registry, xmlObjectHashes.data(), header->objectCount * 4 * sizeof(uint32));
+    for (int32 o = 0; o < header->objectCount; ++o) {
+        uint32 *hash = &xmlObjectHashes[o * 4];
+
+        globalObjectIDs[globalObjectCount] = 0;
+        for (int32 objID = 0; objID < objectClassCount; ++objID) {
+            if (HASH_MATCH_MD5(hash, objectClassList[objID].hash)) {
+                globalObjectIDs[globalObjectCount] = objID;
+                globalObjectCount++;
+            }
+        }
+    }
+
+    xmlSfxList.resize(header->sfxCount);
+    ReadCookedBlock(registry, xmlSfxList.data(), header->sfxCount * sizeof(XMLSfxEntry));
+    for (int32 s = 0; s < header->sfxCount; ++s) LoadSfx(xmlSfxList[s].path, xmlSfxList[s].maxConcurrentPlays, SCOPE_GLOBAL);
+
+    xmlPaletteList.resize(header->paletteCount);
+    ReadCookedBlock(registry, xmlPaletteList.data(), header->paletteCount * sizeof(XMLPaletteEntry));
+    xmlPalettesLoaded = true;
+}
+
+static void SaveGameRegistry(CookedAsset *registry, int32 varOffset)
+{
+    GameRegistryHeader header;
+    memset(&header, 0, sizeof(header));
+    header.categoryCount    = sceneInfo.categoryCount;
+    header.listCategorySize = (int32)listCategory.size();
+    header.listDataSize     = (int32)listData.size();
+    header.varOffset        = varOffset;
+    header.objectCount      = (int32)(xmlObjectHashes.size() / 4);
+    header.sfxCount         = (int32)xmlSfxList.size();
+    header.paletteCount     = (int32)xmlPaletteList.size();
+    sprintf_s(header.gameTitle, sizeof(header.gameTitle), "%s", xmlGameTitle);
+
+    void *blocks[]     = { &header, listCategory.data(), listData.data(), xmlObjectHashes.data(), xmlSfxList.data(), xmlPaletteList.data() };
+    int32 blockSizes[] = { sizeof(header),
+                           header.listCategorySize * (int32)sizeof(SceneListInfo),
+                           header.listDataSize * (int32)sizeof(SceneListEntry),
+                           header.objectCount * 4 * (int32)sizeof(uint32),
+                           header.sfxCount * (int32)sizeof(XMLSfxEntry),
+                           header.paletteCount * (int32)sizeof(XMLPaletteEntry) };
+    SaveCookedAsset(registry, blocks, blockSizes, 6);
 }
 #endif
+#endif
 
 void RSDK::LoadGameConfig()
 {
@@ -1083,82 +1466,118 @@ void RSDK::LoadGameConfig()
 
         uint16 totalSceneCount = ReadInt16(&info);
 
-        if (!totalSceneCount)
-            totalSceneCount = 1;
+#if RETRO_USE_MOD_LOADER && !RETRO_USE_ORIGINAL_CODE
+        // the scene list (& anything Game.xml adds) can come straight from the cooked registry, unless a scene was picked from the command line
+        bool32 canCacheRegistry = !strlen(currentSceneFolder) || !strlen(currentSceneID);
+
+        CookedAsset registry;
+        GameRegistryHeader registryHeader;
+        bool32 loadedRegistry = canCacheRegistry && LoadGameRegistry(&registry, &info);
+        if (loadedRegistry) {
+            ReadGameRegistry(&registry, &registryHeader);
+            Seek_Set(&info, registryHeader.varOffset);
+        }
+        else {
+#endif
+            if (!totalSceneCount)
+                totalSceneCount = 1;
 
-        if (strlen(currentSceneFolder) && strlen(currentSceneID)) {
+            if (strlen(currentSceneFolder) && strlen(currentSceneID)) {
 #if RETRO_USE_MOD_LOADER
-            listData.resize(totalSceneCount + 1);
-            sceneInfo.listData = listData.data();
+                listData.resize(totalSceneCount + 1);
+                sceneInfo.listData = listData.data();
 #else
-            AllocateStorage((void **)&sceneInfo.listData, sizeof(SceneListEntry) * (totalSceneCount + 1), DATASET_STG, false);
+                AllocateStorage((void **)&sceneInfo.listData, sizeof(SceneListEntry) * (totalSceneCount + 1), DATASET_STG, false);
 #endif
-            SceneListEntry *scene = &sceneInfo.listData[totalSceneCount];
-            strcpy(scene->name, "_RSDK_SCENE");
-            strcpy(scene->folder, currentSceneFolder);
-            strcpy(scene->id, currentSceneID);
+                SceneListEntry *scene = &sceneInfo.listData[totalSceneCount];
+                strcpy(scene->name, "_RSDK_SCENE");
+                strcpy(scene->folder, currentSceneFolder);
+                strcpy(scene->id, currentSceneID);
 #if RETRO_REV02
-            scene->filter = sceneInfo.filter;
+                scene->filter = sceneInfo.filter;
 #endif
-            GEN_HASH_MD5(scene->name, scene->hash);
+                GEN_HASH_MD5(scene->name, scene->hash);
 
-            // Override existing values
-            sceneInfo.activeCategory = 0;
-            startScene               = totalSceneCount;
-            currentSceneFolder[0]    = 0;
-            currentSceneID[0]        = 0;
-        }
-        else {
+                // Override existing values
+                sceneInfo.activeCategory = 0;
+                startScene               = totalSceneCount;
+                currentSceneFolder[0]    = 0;
+                currentSceneID[0]        = 0;
+            }
+            else {
 #if RETRO_USE_MOD_LOADER
-            listData.resize(totalSceneCount);
-            sceneInfo.listData = listData.data();
+                listData.resize(totalSceneCount);
+                sceneInfo.listData = listData.data();
 #else
-            AllocateStorage((void **)&sceneInfo.listData, sizeof(SceneListEntry) * totalSceneCount, DATASET_STG, false);
+                AllocateStorage((void **)&sceneInfo.listData, sizeof(SceneListEntry) * totalSceneCount, DATASET_STG, false);
 #endif
-        }
+            }
 
-        sceneInfo.categoryCount = ReadInt8(&info);
-        sceneInfo.listPos       = 0;
+            sceneInfo.categoryCount = ReadInt8(&info);
+            sceneInfo.listPos       = 0;
 
-        int32 categoryCount = sceneInfo.categoryCount;
+            int32 categoryCount = sceneInfo.categoryCount;
 
-        if (!categoryCount)
-            categoryCount = 1;
+            if (!categoryCount)
+                categoryCount = 1;
 
 #if RETRO_USE_MOD_LOADER
-        listCategory.resize(categoryCount);
-        sceneInfo.listCategory = listCategory.data();
+            listCategory.resize(categoryCount);
+            sceneInfo.listCategory = listCategory.data();
 #else
-        AllocateStorage((void **)&sceneInfo.listCategory, sizeof(SceneListInfo) * categoryCount, DATASET_STG, false);
+            AllocateStorage((void **)&sceneInfo.listCategory, sizeof(SceneListInfo) * categoryCount, DATASET_STG, false);
 #endif
-        sceneInfo.listPos = 0;
+            sceneInfo.listPos = 0;
 
-        int32 sceneID = 0;
-        for (int32 i = 0; i < sceneInfo.categoryCount; ++i) {
-            SceneListInfo *category = &sceneInfo.listCategory[i];
-            ReadString(&info, category->name);
-            GEN_HASH_MD5(category->name, category->hash);
+            int32 sceneID = 0;
+            for (int32 i = 0; i < sceneInfo.categoryCount; ++i) {
+                SceneListInfo *category = &sceneInfo.listCategory[i];
+                ReadString(&info, category->name);
+                GEN_HASH_MD5(category->name, category->hash);
 
-            category->sceneOffsetStart = sceneID;
-            category->sceneCount       = ReadInt8(&info);
-            for (int32 s = 0; s < category->sceneCount; ++s) {
-                SceneListEntry *scene = &sceneInfo.listData[sceneID + s];
-                ReadString(&info, scene->name);
-                GEN_HASH_MD5(scene->name, scene->hash);
+                category->sceneOffsetStart = sceneID;
+                category->sceneCount       = ReadInt8(&info);
+                for (int32 s = 0; s < category->sceneCount; ++s) {
+                    SceneListEntry *scene = &sceneInfo.listData[sceneID + s];
+                    ReadString(&info, scene->name);
+#if RETRO_USE_ORIGINAL_CODE
+                    GEN_HASH_MD5(scene->name, scene->hash);
+#endif
 
-                ReadString(&info, scene->folder);
-                ReadString(&info, scene->id);
+                    ReadString(&info, scene->folder);
+                    ReadString(&info, scene->id);
 
 #if RETRO_REV02
-                scene->filter = ReadInt8(&info);
-                if (scene->filter == 0x00)
-                    scene->filter = 0xFF;
+                    scene->filter = ReadInt8(&info);
+                    if (scene->filter == 0x00)
+                        scene->filter = 0xFF;
 #endif
+                }
+                category->sceneOffsetEnd = category->sceneOffsetStart + category->sceneCount;
+                sceneID += category->sceneCount;
+            }
+
+#if !RETRO_USE_ORIGINAL_CODE
+            // every scene name gets hashed once and they're (almost) all unique, so rather than interning them
+            // hash the whole list a few at a time
+            const char *sceneNames[0x40];
+            uint32 *sceneHashes[0x40];
+            for (int32 s = 0; s < sceneID; s += 0x40) {
+                int32 count = MIN(sceneID - s, 0x40);
+                for (int32 i = 0; i < count; ++i) {
+                    sceneNames[i]  = sceneInfo.listData[s + i].name;
+                    sceneHashes[i] = sceneInfo.listData[s + i].hash;
+                }
+
+                GenerateHashMD5Multi(sceneHashes, sceneNames, count);
             }
-            category->sceneOffsetEnd = category->sceneOffsetStart + category->sceneCount;
-            sceneID += category->sceneCount;
+#endif
+#if RETRO_USE_MOD_LOADER && !RETRO_USE_ORIGINAL_CODE
         }
 
+        int32 varOffset = info.readPos;
+#endif
+
         uint8 varCount = ReadInt8(&info);
         for (int32 i = 0; i < varCount; ++i) {
 #if RETRO_REV0U
@@ -1180,14 +1599,29 @@ void RSDK::LoadGameConfig()
 
         CloseFile(&info);
 #if RETRO_USE_MOD_LOADER
+#if !RETRO_USE_ORIGINAL_CODE
+        if (loadedRegistry) {
+            ApplyGameRegistry(&registry, &registryHeader);
+            CloseCookedAsset(&registry);
+        }
+        else {
+            LoadGameXML();
+            if (canCacheRegistry)
+                SaveGameRegistry(&registry, varOffset);
+        }
+#else
         LoadGameXML();
 #endif
+#endif
 
 #if RETRO_REV0U
         if (globalVarsInitCB)
             globalVarsInitCB(globalVarsPtr);
 #endif
 
+#if !RETRO_USE_ORIGINAL_CODE
+        sceneListIndex.Invalidate();
+#endif
         sceneInfo.listPos = sceneInfo.listCategory[sceneInfo.activeCategory].sceneOffsetStart + startScene;
     }
 }
@@ -1196,8 +1630,13 @@ void RSDK::InitGameLink()
 {
 #if RETRO_USE_MOD_LOADER
     objectClassCount = 0;
+#if !RETRO_USE_ORIGINAL_CODE
+    objectClassIndex.Invalidate();
+#endif
     memset(globalObjectIDs, 0, sizeof(globalObjectIDs));
+#if RETRO_USE_ORIGINAL_CODE
     memset(objectEntityList, 0, sizeof(objectEntityList));
+#endif
     editableVarCount = 0;
     foreachStackPtr  = foreachStackList;
     currentMod       = NULL;
@@ -1335,6 +1774,7 @@ void RSDK::InitGameLink()
         for (modLinkSTD linkModLogic : modList[m].linkModLogic) {
             if (!linkModLogic(&info, modList[m].id.c_str())) {
                 modList[m].active = false;
+                InvalidateModFileIndex();
                 PrintLog(PRINT_ERROR, "[MOD] Failed to link logic for mod %s!", modList[m].id.c_str());
             }
         }
@@ -1342,6 +1782,11 @@ void RSDK::InitGameLink()
 
     currentMod = NULL;
 #endif
+
+#if !RETRO_USE_ORIGINAL_CODE
+    // every class is registered now, so the entity list can be (re)allocated & cleared
+    UpdateEntityStride();
+#endif
 }
 
 void RSDK::ProcessDebugCommands()
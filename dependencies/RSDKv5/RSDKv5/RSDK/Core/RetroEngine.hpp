@@ -374,7 +374,33 @@ enum GameRegions {
 
 // Defines the version of the mod loader, this should be changed ONLY if the ModFunctionTable is updated in any way
 #ifndef RETRO_MOD_LOADER_VER
-#define RETRO_MOD_LOADER_VER (2)
+#define RETRO_MOD_LOADER_VER (3)
+#endif
+
+// Enables SSE2 intrinsics in a few of the bulk data conversion paths, every path has a plain C++ fallback that produces identical results
+#ifndef RETRO_USE_SSE2
+#if !RETRO_USE_ORIGINAL_CODE && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define RETRO_USE_SSE2 (1)
+#else
+#define RETRO_USE_SSE2 (0)
+#endif
+#endif
+
+// Same idea for AltiVec/VMX (the PS3's PPU), only used in places that also have an SSE2 path
+#ifndef RETRO_USE_ALTIVEC
+#if !RETRO_USE_ORIGINAL_CODE && defined(__ALTIVEC__)
+#define RETRO_USE_ALTIVEC (1)
+#else
+#define RETRO_USE_ALTIVEC (0)
+#endif
+#endif
+
+#if RETRO_USE_ALTIVEC
+#include <altivec.h>
+// altivec.h turns these into keywords, which breaks std::vector & friends
+#undef vector
+#undef pixel
+#undef bool
 #endif
 
 // ============================
@@ -663,6 +689,51 @@ extern "C" {
 #endif
 #endif
 
+#if !RETRO_USE_ORIGINAL_CODE
+// ============================
+// THREADING
+// ============================
+
+// the engine's worker threads (file prefetching, sprite decoding, isolated entity updates) all go through these,
+// SDL's threads & atomics are used whenever SDL is around, the standard library's otherwise
+#if RETRO_RENDERDEVICE_SDL2 || RETRO_INPUTDEVICE_SDL2 || RETRO_AUDIODEVICE_SDL2
+#define RETRO_USE_SDL_THREADS (1)
+#else
+#define RETRO_USE_SDL_THREADS (0)
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace RSDK
+{
+#if RETRO_USE_SDL_THREADS
+typedef SDL_atomic_t ThreadAtomic;
+
+inline int32 GetAtomic(ThreadAtomic &var) { return SDL_AtomicGet(&var); }
+inline int32 SetAtomic(ThreadAtomic &var, int32 value) { return SDL_AtomicSet(&var, value); }
+inline int32 AddAtomic(ThreadAtomic &var, int32 value) { return SDL_AtomicAdd(&var, value); }
+inline bool32 SwapAtomic(ThreadAtomic &var, int32 oldValue, int32 newValue) { return SDL_AtomicCAS(&var, oldValue, newValue); }
+
+inline void ThreadYield() { SDL_Delay(0); }
+inline void ThreadSleep() { SDL_Delay(1); }
+#else
+typedef std::atomic<int32> ThreadAtomic;
+
+inline int32 GetAtomic(ThreadAtomic &var) { return var.load(); }
+inline int32 SetAtomic(ThreadAtomic &var, int32 value) { return var.exchange(value); }
+inline int32 AddAtomic(ThreadAtomic &var, int32 value) { return var.fetch_add(value); }
+inline bool32 SwapAtomic(ThreadAtomic &var, int32 oldValue, int32 newValue) { return var.compare_exchange_strong(oldValue, newValue); }
+
+inline void ThreadYield() { std::this_thread::yield(); }
+inline void ThreadSleep() { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+#endif
+// Set & Add both return the value from before the change, Swap only changes it if it still holds oldValue
+} // namespace RSDK
+#endif
+
 #include <theora/theoradec.h>
 
 // ============================
@@ -733,6 +804,12 @@ struct RetroEngine {
 
     bool32 devMenu        = false;
     bool32 consoleEnabled = (RETRO_PLATFORM == RETRO_PS3) ? true : false;
+#if !RETRO_USE_ORIGINAL_CODE
+    bool32 cookAssets = false; // "cook=true", loads every scene once so their cooked assets get written, then quits
+    int32 spriteDecodeThreads = 2; // "decodethreads=N", worker threads used for sprite sheets during stage load, 0 decodes them in place
+    int32 updateThreads = 2; // "updatethreads=N", worker threads used for isolated entity updates, 0 runs them on the main thread
+    bool32 checkIsolated = false; // "checkisolated=true", looks for isolated updates that write outside their own entity
+#endif
 
     bool32 confirmFlip = false; // swaps A/B, used for nintendo and etc controllers
     bool32 XYFlip      = false; // swaps X/Y, used for nintendo and etc controllers
@@ -829,6 +906,9 @@ inline void SetGameFinished() { sceneInfo.state = ENGINESTATE_GAME_FINISHED; }
 #endif
 
 extern int32 *globalVarsPtr;
+#if !RETRO_USE_ORIGINAL_CODE
+extern int32 globalVarsSize;
+#endif
 
 #if RETRO_REV0U
 extern void (*globalVarsInitCB)(void *globals);
@@ -838,12 +918,18 @@ inline void RegisterGlobalVariables(void **globals, int32 size, void (*initCB)(v
     AllocateStorage(globals, size, DATASET_STG, true);
     globalVarsPtr    = (int32 *)*globals;
     globalVarsInitCB = initCB;
+#if !RETRO_USE_ORIGINAL_CODE
+    globalVarsSize = size;
+#endif
 }
 #else
 inline void RegisterGlobalVariables(void **globals, int32 size)
 {
     AllocateStorage(globals, size, DATASET_STG, true);
     globalVarsPtr = (int32 *)*globals;
+#if !RETRO_USE_ORIGINAL_CODE
+    globalVarsSize = size;
+#endif
 }
 #endif
 
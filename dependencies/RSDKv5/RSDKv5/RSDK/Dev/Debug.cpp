@@ -188,6 +188,174 @@ void RSDK::PrintMessage(void *msg, uint8 type)
 }
 #endif
 
+#if !RETRO_USE_ORIGINAL_CODE
+#if !(RETRO_RENDERDEVICE_SDL2 || RETRO_AUDIODEVICE_SDL2 || RETRO_INPUTDEVICE_SDL2) && !(RETRO_PLATFORM == RETRO_WIN || RETRO_PLATFORM == RETRO_UWP)
+#include <chrono>
+#endif
+
+Profiler RSDK::profiler;
+
+struct ProfilerEntryInfo {
+    const char *name;
+    uint8 type;
+};
+
+const ProfilerEntryInfo profilerEntryInfo[PROFILE_COUNT] = {
+    { "Scene Load", PROFILETYPE_LOAD },
+    { "SFX Load", PROFILETYPE_LOAD },
+    { "SFX Cache Hit", PROFILETYPE_COUNTER },
+    { "SFX Cache Miss", PROFILETYPE_COUNTER },
+    { "Stream Seek", PROFILETYPE_EVENT },
+    { "Name Hashing", PROFILETYPE_LOAD },
+    { "Hash Intern Hit", PROFILETYPE_COUNTER },
+    { "Hash Intern Miss", PROFILETYPE_COUNTER },
+    { "Stage Folder Load", PROFILETYPE_LOAD },
+    { "  TileConfig", PROFILETYPE_LOAD },
+    { "  StageConfig", PROFILETYPE_LOAD },
+    { "  Tileset", PROFILETYPE_LOAD },
+    { "Scene Layout Load", PROFILETYPE_LOAD },
+    { "Object Init", PROFILETYPE_LOAD },
+    { "Prefetch Read", PROFILETYPE_LOAD },
+    { "Prefetch Wait", PROFILETYPE_LOAD },
+    { "Prefetch Hit", PROFILETYPE_COUNTER },
+    { "Prefetch Miss", PROFILETYPE_COUNTER },
+    { "GIF Decode", PROFILETYPE_LOAD },
+    { "Cooked Asset Hit", PROFILETYPE_COUNTER },
+    { "Cooked Asset Write", PROFILETYPE_COUNTER },
+    { "TMP Peak", PROFILETYPE_MEMORY },
+    { "TMP Collect", PROFILETYPE_COUNTER },
+    { "Sprite Decode Wait", PROFILETYPE_LOAD },
+    { "Scene Preload", PROFILETYPE_LOAD },
+    { "Scene Staging", PROFILETYPE_LOAD },
+    { "Staged Layer", PROFILETYPE_COUNTER },
+    { "Broadphase Build", PROFILETYPE_FRAME },
+    { "Bounds Query Group", PROFILETYPE_COUNTER },
+    { "Bounds Query Result", PROFILETYPE_COUNTER },
+    { "Snapshot Capture", PROFILETYPE_EVENT },
+    { "Snapshot Restore", PROFILETYPE_EVENT },
+    { "Snapshot Bytes", PROFILETYPE_COUNTER },
+    { "Entity Create", PROFILETYPE_COUNTER },
+    { "Entity Create Walk", PROFILETYPE_COUNTER },
+    { "Entity Create Probe", PROFILETYPE_COUNTER },
+    { "Entity Overwrite", PROFILETYPE_COUNTER },
+    { "Isolated Update", PROFILETYPE_FRAME },
+    { "Isolated Entity", PROFILETYPE_COUNTER },
+    { "Repeat Present", PROFILETYPE_COUNTER },
+};
+
+uint64 RSDK::GetProfilerTicks()
+{
+#if RETRO_RENDERDEVICE_SDL2 || RETRO_AUDIODEVICE_SDL2 || RETRO_INPUTDEVICE_SDL2
+    return SDL_GetPerformanceCounter();
+#elif RETRO_PLATFORM == RETRO_WIN || RETRO_PLATFORM == RETRO_UWP
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+uint64 RSDK::GetProfilerFrequency()
+{
+#if RETRO_RENDERDEVICE_SDL2 || RETRO_AUDIODEVICE_SDL2 || RETRO_INPUTDEVICE_SDL2
+    return SDL_GetPerformanceFrequency();
+#elif RETRO_PLATFORM == RETRO_WIN || RETRO_PLATFORM == RETRO_UWP
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    return frequency.QuadPart;
+#else
+    return 1000000000;
+#endif
+}
+
+// times are kept in microseconds here, the atomics are only 32 bits wide
+struct ProfilerPending {
+    ThreadAtomic total;
+    ThreadAtomic peak;
+    ThreadAtomic count;
+};
+
+static ProfilerPending profilerPending[PROFILE_COUNT];
+
+void RSDK::AddProfileTicksAsync(int32 id, uint64 ticks)
+{
+    ProfilerPending *pending = &profilerPending[id];
+
+    int32 micros = (int32)MIN(ticks * 1000000 / GetProfilerFrequency(), 0x7FFFFFFF);
+    AddAtomic(pending->total, micros);
+    AddAtomic(pending->count, 1);
+
+    int32 peak = GetAtomic(pending->peak);
+    while (micros > peak && !SwapAtomic(pending->peak, peak, micros)) peak = GetAtomic(pending->peak);
+}
+
+void RSDK::SyncProfiler()
+{
+    uint64 frequency = GetProfilerFrequency();
+
+    for (int32 p = 0; p < PROFILE_COUNT; ++p) {
+        ProfilerPending *pending = &profilerPending[p];
+        if (!GetAtomic(pending->count))
+            continue;
+
+        ProfilerEntry *entry = &profiler.entries[p];
+        entry->count += SetAtomic(pending->count, 0);
+        entry->totalTicks += (uint32)SetAtomic(pending->total, 0) * frequency / 1000000;
+
+        uint64 peakTicks = (uint32)SetAtomic(pending->peak, 0) * frequency / 1000000;
+        if (peakTicks > entry->peakTicks)
+            entry->peakTicks = peakTicks;
+    }
+}
+
+void RSDK::ResetProfiler()
+{
+    memset(&profiler, 0, sizeof(profiler));
+
+    for (int32 p = 0; p < PROFILE_COUNT; ++p) {
+        SetAtomic(profilerPending[p].total, 0);
+        SetAtomic(profilerPending[p].peak, 0);
+        SetAtomic(profilerPending[p].count, 0);
+    }
+}
+
+void GetProfilerEntryString(int32 id, char *buffer, size_t size)
+{
+    ProfilerEntry *entry = &profiler.entries[id];
+    double msPerTick     = 1000.0 / (double)GetProfilerFrequency();
+
+    switch (profilerEntryInfo[id].type) {
+        default:
+        case PROFILETYPE_LOAD: snprintf(buffer, size, "%.2fms", entry->totalTicks * msPerTick); break;
+
+        case PROFILETYPE_FRAME:
+            snprintf(buffer, size, "%.3fms", profiler.frameCount ? (entry->totalTicks * msPerTick) / profiler.frameCount : 0.0);
+            break;
+
+        case PROFILETYPE_EVENT:
+            snprintf(buffer, size, "%.2f/%.2fms", entry->count ? (entry->totalTicks * msPerTick) / entry->count : 0.0, entry->peakTicks * msPerTick);
+            break;
+
+        case PROFILETYPE_COUNTER: snprintf(buffer, size, "%u", entry->count); break;
+
+        case PROFILETYPE_MEMORY: snprintf(buffer, size, "%.1fKB", entry->count / 1024.0); break;
+    }
+}
+
+void RSDK::PrintProfilerReport()
+{
+    char valueStr[0x20];
+
+    SyncProfiler();
+    PrintLog(PRINT_NORMAL, "Profiler:");
+    for (int32 p = 0; p < PROFILE_COUNT; ++p) {
+        GetProfilerEntryString(p, valueStr, sizeof(valueStr));
+        PrintLog(PRINT_NORMAL, "  %s: %s (%u)", profilerEntryInfo[p].name, valueStr, profiler.entries[p].count);
+    }
+}
+#endif
+
 #if !RETRO_USE_ORIGINAL_CODE
 uint8 touchTimer = 0;
 
@@ -832,11 +1000,17 @@ void RSDK::DevMenu_SceneSelectMenu()
 }
 void RSDK::DevMenu_OptionsMenu()
 {
+#if !RETRO_USE_ORIGINAL_CODE
+    // +1 for the profiler entry
+    const uint8 selectionCount = RETRO_REV02 ? 6 : 5;
+    uint32 selectionColors[]   = { 0x808090, 0x808090, 0x808090, 0x808090, 0x808090, 0x808090 };
+#else
     const uint8 selectionCount = RETRO_REV02 ? 5 : 4;
 #if RETRO_REV02
     uint32 selectionColors[] = { 0x808090, 0x808090, 0x808090, 0x808090, 0x808090 };
 #else
     uint32 selectionColors[] = { 0x808090, 0x808090, 0x808090, 0x808090 };
+#endif
 #endif
     selectionColors[devMenu.selection] = 0xF0F0F0;
 
@@ -847,7 +1021,11 @@ void RSDK::DevMenu_OptionsMenu()
     DrawDevString("OPTIONS", currentScreen->center.x, dy, ALIGN_CENTER, 0xF0F0F0);
 
     dy += 44;
+#if !RETRO_USE_ORIGINAL_CODE
+    DrawRectangle(currentScreen->center.x - 128, dy - 8, 0x100, RETRO_REV02 ? 0x54 : 0x48, 0x80, 0xFF, INK_NONE, true);
+#else
     DrawRectangle(currentScreen->center.x - 128, dy - 8, 0x100, 0x48, 0x80, 0xFF, INK_NONE, true);
+#endif
 
     DrawDevString("Video Settings", currentScreen->center.x, dy, ALIGN_CENTER, selectionColors[0]);
 
@@ -861,6 +1039,11 @@ void RSDK::DevMenu_OptionsMenu()
     dy += 12;
     DrawDevString("Debug Flags", currentScreen->center.x, dy, ALIGN_CENTER, selectionColors[3]);
 
+#endif
+#if !RETRO_USE_ORIGINAL_CODE
+    dy += 12;
+    DrawDevString("Profiler", currentScreen->center.x, dy, ALIGN_CENTER, selectionColors[selectionCount - 2]);
+
 #endif
     DrawDevString("Back", currentScreen->center.x, dy + 12, ALIGN_CENTER, selectionColors[selectionCount - 1]);
 
@@ -943,11 +1126,17 @@ void RSDK::DevMenu_OptionsMenu()
                 devMenu.scrollPos = 0;
 #endif
                 break;
+#endif
 
-            case 4:
-#else
-            case 3:
+#if !RETRO_USE_ORIGINAL_CODE
+            case selectionCount - 2:
+                devMenu.state     = DevMenu_ProfilerMenu;
+                devMenu.selection = 0;
+                devMenu.scrollPos = 0;
+                break;
 #endif
+
+            case selectionCount - 1:
                 devMenu.state     = DevMenu_MainMenu;
                 devMenu.selection = 0;
                 break;
@@ -1832,6 +2021,104 @@ void RSDK::DevMenu_DebugOptionsMenu()
 }
 #endif
 
+#if !RETRO_USE_ORIGINAL_CODE
+void RSDK::DevMenu_ProfilerMenu()
+{
+    uint32 selectionColors[]                               = { 0x808090, 0x808090, 0x808090, 0x808090, 0x808090, 0x808090, 0x808090, 0x808090 };
+    selectionColors[devMenu.selection - devMenu.scrollPos] = 0xF0F0F0;
+
+    int32 dy = currentScreen->center.y;
+    DrawRectangle(currentScreen->center.x - 128, dy - 84, 0x100, 0x30, 0x80, 0xFF, INK_NONE, true);
+
+    dy -= 68;
+    DrawDevString("PROFILER", currentScreen->center.x, dy, ALIGN_CENTER, 0xF0F0F0);
+
+    SyncProfiler();
+
+    dy += 40;
+    DrawRectangle(currentScreen->center.x - 128, dy - 4, 0x100, 0x48, 0x80, 0xFF, INK_NONE, true);
+
+    DevMenu_HandleTouchControls(CORNERBUTTON_START);
+
+    for (int32 i = 0; i < 8; ++i) {
+        int32 id = devMenu.scrollPos + i;
+
+        if (id < PROFILE_COUNT) {
+            char valueStr[0x20];
+            GetProfilerEntryString(id, valueStr, sizeof(valueStr));
+
+            DrawDevString(profilerEntryInfo[id].name, currentScreen->center.x - 96, dy, ALIGN_LEFT, selectionColors[i]);
+            DrawDevString(valueStr, currentScreen->center.x + 96, dy, ALIGN_RIGHT, 0xF0F080);
+            dy += 8;
+        }
+        else {
+            DrawDevString("Back", currentScreen->center.x, dy, ALIGN_CENTER, selectionColors[i]);
+            break;
+        }
+    }
+
+    if (controller[CONT_ANY].keyUp.press) {
+        if (--devMenu.selection < 0)
+            devMenu.selection = PROFILE_COUNT;
+
+        devMenu.timer = 1;
+    }
+    else if (controller[CONT_ANY].keyUp.down) {
+        if (!devMenu.timer && --devMenu.selection < 0)
+            devMenu.selection = PROFILE_COUNT;
+
+        devMenu.timer = (devMenu.timer + 1) & 7;
+    }
+
+    if (controller[CONT_ANY].keyDown.press) {
+        if (++devMenu.selection > PROFILE_COUNT)
+            devMenu.selection = 0;
+
+        devMenu.timer = 1;
+    }
+    else if (controller[CONT_ANY].keyDown.down) {
+        if (!devMenu.timer && ++devMenu.selection > PROFILE_COUNT)
+            devMenu.selection = 0;
+
+        devMenu.timer = (devMenu.timer + 1) & 7;
+    }
+
+    if (devMenu.selection >= devMenu.scrollPos) {
+        if (devMenu.selection > devMenu.scrollPos + 7)
+            devMenu.scrollPos = devMenu.selection - 7;
+    }
+    else {
+        devMenu.scrollPos = devMenu.selection;
+    }
+
+    bool32 confirm = controller[CONT_ANY].keyA.press;
+#if RETRO_REV02
+    bool32 swap = SKU::userCore->GetConfirmButtonFlip();
+#else
+    bool32 swap = SKU::GetConfirmButtonFlip();
+#endif
+    if (swap)
+        confirm = controller[CONT_ANY].keyB.press;
+
+    if (controller[CONT_ANY].keyStart.press || confirm) {
+        // confirming on an entry resets it, confirming on "Back" leaves
+        if (devMenu.selection < PROFILE_COUNT) {
+            memset(&profiler.entries[devMenu.selection], 0, sizeof(ProfilerEntry));
+        }
+        else {
+            devMenu.state     = DevMenu_OptionsMenu;
+            devMenu.selection = RETRO_REV02 ? 4 : 3;
+            devMenu.scrollPos = 0;
+        }
+    }
+    else if (swap ? controller[CONT_ANY].keyA.press : controller[CONT_ANY].keyB.press) {
+        devMenu.state     = DevMenu_OptionsMenu;
+        devMenu.selection = RETRO_REV02 ? 4 : 3;
+        devMenu.scrollPos = 0;
+    }
+}
+#endif
+
 #if RETRO_USE_MOD_LOADER
 void RSDK::DevMenu_ModsMenu()
 {
@@ -1931,12 +2218,14 @@ void RSDK::DevMenu_ModsMenu()
     if (controller[CONT_ANY].keyStart.press || confirm || controller[CONT_ANY].keyLeft.press || controller[CONT_ANY].keyRight.press) {
         modList[devMenu.selection].active ^= true;
         devMenu.modsChanged = true;
+        InvalidateModFileIndex();
     }
     else if (controller[CONT_ANY].keyC.down) {
         ModInfo swap               = modList[preselection];
         modList[preselection]      = modList[devMenu.selection];
         modList[devMenu.selection] = swap;
         devMenu.modsChanged        = true;
+        InvalidateModFileIndex();
     }
     else if (swap ? controller[CONT_ANY].keyA.press : controller[CONT_ANY].keyB.press) {
         devMenu.state     = DevMenu_MainMenu;
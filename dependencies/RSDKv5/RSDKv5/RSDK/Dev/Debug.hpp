@@ -102,6 +102,114 @@ inline void ClearViewableVariables() { viewableVarCount = 0; }
 void AddViewableVariable(const char *name, void *value, int32 type, int32 min, int32 max);
 #endif
 
+#if !RETRO_USE_ORIGINAL_CODE
+// A small built-in profiler, timers are reset whenever a scene starts loading so the results always reflect the current scene
+enum ProfilerEntryIDs {
+    PROFILE_SCENE_LOAD,
+    PROFILE_SFX_LOAD,
+    PROFILE_SFX_CACHE_HITS,
+    PROFILE_SFX_CACHE_MISSES,
+    PROFILE_STREAM_SEEK,
+    PROFILE_HASHING,
+    PROFILE_HASH_INTERN_HITS,
+    PROFILE_HASH_INTERN_MISSES,
+    PROFILE_LOAD_FOLDER,
+    PROFILE_LOAD_TILECONFIG,
+    PROFILE_LOAD_STAGECONFIG,
+    PROFILE_LOAD_TILESET,
+    PROFILE_LOAD_SCENE,
+    PROFILE_LOAD_OBJECTS,
+    PROFILE_PREFETCH_READ,
+    PROFILE_PREFETCH_WAIT,
+    PROFILE_PREFETCH_HITS,
+    PROFILE_PREFETCH_MISSES,
+    PROFILE_GIF_DECODE,
+    PROFILE_COOKED_HITS,
+    PROFILE_COOKED_WRITES,
+    PROFILE_TMP_PEAK,
+    PROFILE_TMP_COLLECTS,
+    PROFILE_SPRITE_DECODE_WAIT,
+    PROFILE_SCENE_PRELOAD,
+    PROFILE_SCENE_STAGING,
+    PROFILE_STAGED_LAYERS,
+    PROFILE_BROADPHASE_BUILD,
+    PROFILE_BOUNDS_QUERY_GROUP,
+    PROFILE_BOUNDS_QUERY_RESULTS,
+    PROFILE_SNAPSHOT_CAPTURE,
+    PROFILE_SNAPSHOT_RESTORE,
+    PROFILE_SNAPSHOT_BYTES,
+    PROFILE_ENTITY_CREATE,
+    PROFILE_ENTITY_CREATE_WALK,
+    PROFILE_ENTITY_CREATE_PROBES,
+    PROFILE_ENTITY_CREATE_OVERWRITE,
+    PROFILE_ISOLATED_UPDATE,
+    PROFILE_ISOLATED_ENTITIES,
+    PROFILE_REPEAT_PRESENT,
+    PROFILE_COUNT,
+};
+
+enum ProfilerEntryTypes {
+    PROFILETYPE_LOAD,    // total time spent since the scene started loading
+    PROFILETYPE_FRAME,   // average time spent per frame
+    PROFILETYPE_EVENT,   // average & peak time spent per call
+    PROFILETYPE_COUNTER, // no timing, just counts
+    PROFILETYPE_MEMORY,  // no timing, the largest size (in bytes) seen
+};
+
+struct ProfilerEntry {
+    uint64 startTicks;
+    uint64 totalTicks;
+    uint64 peakTicks;
+    uint32 count;
+};
+
+struct Profiler {
+    ProfilerEntry entries[PROFILE_COUNT];
+    uint32 frameCount;
+};
+
+extern Profiler profiler;
+
+uint64 GetProfilerTicks();
+uint64 GetProfilerFrequency();
+
+inline void BeginProfile(int32 id) { profiler.entries[id].startTicks = GetProfilerTicks(); }
+inline void EndProfile(int32 id)
+{
+    ProfilerEntry *entry = &profiler.entries[id];
+
+    uint64 ticks = GetProfilerTicks() - entry->startTicks;
+    entry->totalTicks += ticks;
+    if (ticks > entry->peakTicks)
+        entry->peakTicks = ticks;
+    ++entry->count;
+}
+inline void AddProfileCount(int32 id, uint32 count) { profiler.entries[id].count += count; }
+inline void SetProfilePeak(int32 id, uint32 size)
+{
+    if (size > profiler.entries[id].count)
+        profiler.entries[id].count = size;
+}
+// for time measured elsewhere (e.g. on a worker thread)
+inline void AddProfileTicks(int32 id, uint64 ticks)
+{
+    ProfilerEntry *entry = &profiler.entries[id];
+
+    entry->totalTicks += ticks;
+    if (ticks > entry->peakTicks)
+        entry->peakTicks = ticks;
+    ++entry->count;
+}
+
+// AddProfileTicks for threads other than the main one (e.g. the audio callback), the profiler itself is main thread only
+// so these are held in atomics until SyncProfiler() folds them in
+void AddProfileTicksAsync(int32 id, uint64 ticks);
+void SyncProfiler();
+
+void ResetProfiler();
+void PrintProfilerReport();
+#endif
+
 struct DevMenu {
     void (*state)();
     int32 selection;
@@ -135,6 +243,9 @@ void DevMenu_KeyMappingsMenu();
 #if RETRO_REV02
 void DevMenu_DebugOptionsMenu();
 #endif
+#if !RETRO_USE_ORIGINAL_CODE
+void DevMenu_ProfilerMenu();
+#endif
 #if RETRO_USE_MOD_LOADER
 void DevMenu_ModsMenu();
 #endif
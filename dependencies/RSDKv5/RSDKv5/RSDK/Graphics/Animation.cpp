@@ -8,6 +8,34 @@ using namespace RSDK;
 
 SpriteAnimation RSDK::spriteAnimationList[SPRFILE_COUNT];
 
+#if !RETRO_USE_ORIGINAL_CODE
+HashIndexMD5<SPRFILE_COUNT * 2> RSDK::spriteFileIndex;
+HashIndexMD5<SPRITEANIM_INDEX_COUNT> RSDK::spriteAnimationIndex;
+
+void RSDK::BuildSpriteFileIndex()
+{
+    spriteFileIndex.Reset();
+    for (int32 i = 0; i < SPRFILE_COUNT; ++i) spriteFileIndex.Add(spriteAnimationList[i].hash, i);
+}
+
+void RSDK::BuildSpriteAnimationIndex()
+{
+    spriteAnimationIndex.Reset();
+    for (int32 i = 0; i < SPRFILE_COUNT; ++i) {
+        SpriteAnimation *spr = &spriteAnimationList[i];
+        for (int32 a = 0; a < spr->animCount; ++a) spriteAnimationIndex.Add(spr->animations[a].hash, a, i);
+    }
+}
+
+uint16 FindSpriteFile(uint32 *hash)
+{
+    if (!spriteFileIndex.valid)
+        BuildSpriteFileIndex();
+
+    return spriteFileIndex.Find(hash);
+}
+#endif
+
 uint16 RSDK::LoadSpriteAnimation(const char *filePath, uint8 scope)
 {
     if (!scope || scope > SCOPE_STAGE)
@@ -19,10 +47,16 @@ uint16 RSDK::LoadSpriteAnimation(const char *filePath, uint8 scope)
     RETRO_HASH_MD5(hash);
     GEN_HASH_MD5(filePath, hash);
 
+#if !RETRO_USE_ORIGINAL_CODE
+    uint16 existing = FindSpriteFile(hash);
+    if (existing != (uint16)-1)
+        return existing;
+#else
     for (int32 i = 0; i < SPRFILE_COUNT; ++i) {
         if (HASH_MATCH_MD5(spriteAnimationList[i].hash, hash))
             return i;
     }
+#endif
 
     uint16 id = -1;
     for (id = 0; id < SPRFILE_COUNT; ++id) {
@@ -50,6 +84,10 @@ uint16 RSDK::LoadSpriteAnimation(const char *filePath, uint8 scope)
         SpriteAnimation *spr = &spriteAnimationList[id];
         spr->scope           = scope;
         memcpy(spr->hash, hash, 4 * sizeof(uint32));
+#if !RETRO_USE_ORIGINAL_CODE
+        if (spriteFileIndex.valid)
+            spriteFileIndex.Add(hash, id);
+#endif
 
         uint32 frameCount = ReadInt32(&info, false);
         AllocateStorage((void **)&spr->frames, frameCount * sizeof(SpriteFrame), DATASET_STG, false);
@@ -65,6 +103,11 @@ uint16 RSDK::LoadSpriteAnimation(const char *filePath, uint8 scope)
             ReadString(&info, nameBuffer[h]);
         }
 
+#if !RETRO_USE_ORIGINAL_CODE
+        uint8 frameData[0x1000];
+        int32 frameSize = sizeof(uint8) + (8 * sizeof(int16)) + (hitboxCount * 4 * sizeof(int16));
+#endif
+
         spr->animCount = ReadInt16(&info);
         AllocateStorage((void **)&spr->animations, spr->animCount * sizeof(SpriteAnimationEntry), DATASET_STG, false);
 
@@ -73,6 +116,10 @@ uint16 RSDK::LoadSpriteAnimation(const char *filePath, uint8 scope)
             SpriteAnimationEntry *animation = &spr->animations[a];
             ReadString(&info, textBuffer);
             GEN_HASH_MD5(textBuffer, animation->hash);
+#if !RETRO_USE_ORIGINAL_CODE
+            if (spriteAnimationIndex.valid)
+                spriteAnimationIndex.Add(animation->hash, a, id);
+#endif
 
             animation->frameCount      = ReadInt16(&info);
             animation->frameListOffset = frameID;
@@ -80,6 +127,36 @@ uint16 RSDK::LoadSpriteAnimation(const char *filePath, uint8 scope)
             animation->loopIndex       = ReadInt8(&info);
             animation->rotationStyle   = ReadInt8(&info);
 
+#if !RETRO_USE_ORIGINAL_CODE
+            // frames are fixed size, so read them in batches & unpack them from memory rather than reading every value on its own
+            for (int32 f = 0; f < animation->frameCount;) {
+                int32 batchCount = MIN(animation->frameCount - f, (int32)(sizeof(frameData) / frameSize));
+                int32 readSize   = (int32)ReadBytes(&info, frameData, batchCount * frameSize);
+                memset(&frameData[readSize], 0, (batchCount * frameSize) - readSize);
+
+                for (uint8 *data = frameData; batchCount; --batchCount, ++f, data += frameSize) {
+                    SpriteFrame *frame = &spr->frames[frameID++];
+
+                    frame->sheetID     = sheetIDs[data[0]];
+                    frame->duration    = GetInt16LE(&data[1]);
+                    frame->unicodeChar = GetInt16LE(&data[3]);
+                    frame->sprX        = GetInt16LE(&data[5]);
+                    frame->sprY        = GetInt16LE(&data[7]);
+                    frame->width       = GetInt16LE(&data[9]);
+                    frame->height      = GetInt16LE(&data[11]);
+                    frame->pivotX      = GetInt16LE(&data[13]);
+                    frame->pivotY      = GetInt16LE(&data[15]);
+
+                    frame->hitboxCount = hitboxCount;
+                    for (int32 h = 0; h < hitboxCount; ++h) {
+                        frame->hitboxes[h].left   = GetInt16LE(&data[17 + (h * 8) + 0]);
+                        frame->hitboxes[h].top    = GetInt16LE(&data[17 + (h * 8) + 2]);
+                        frame->hitboxes[h].right  = GetInt16LE(&data[17 + (h * 8) + 4]);
+                        frame->hitboxes[h].bottom = GetInt16LE(&data[17 + (h * 8) + 6]);
+                    }
+                }
+            }
+#else
             for (int32 f = 0; f < animation->frameCount; ++f) {
                 SpriteFrame *frame = &spr->frames[frameID++];
 
@@ -101,6 +178,7 @@ uint16 RSDK::LoadSpriteAnimation(const char *filePath, uint8 scope)
                     frame->hitboxes[h].bottom = ReadInt16(&info);
                 }
             }
+#endif
         }
 
         CloseFile(&info);
@@ -122,11 +200,17 @@ uint16 RSDK::CreateSpriteAnimation(const char *filename, uint32 frameCount, uint
     RETRO_HASH_MD5(hash);
     GEN_HASH_MD5(filename, hash);
 
+#if !RETRO_USE_ORIGINAL_CODE
+    uint16 existing = FindSpriteFile(hash);
+    if (existing != (uint16)-1)
+        return existing;
+#else
     for (int32 i = 0; i < SPRFILE_COUNT; ++i) {
         if (HASH_MATCH_MD5(spriteAnimationList[i].hash, hash)) {
             return i;
         }
     }
+#endif
 
     uint16 id = -1;
     for (id = 0; id < SPRFILE_COUNT; ++id) {
@@ -140,6 +224,10 @@ uint16 RSDK::CreateSpriteAnimation(const char *filename, uint32 frameCount, uint
     SpriteAnimation *spr = &spriteAnimationList[id];
     spr->scope           = scope;
     memcpy(spr->hash, hash, 4 * sizeof(uint32));
+#if !RETRO_USE_ORIGINAL_CODE
+    if (spriteFileIndex.valid)
+        spriteFileIndex.Add(hash, id);
+#endif
 
     AllocateStorage((void **)&spr->frames, sizeof(SpriteFrame) * MIN(frameCount, SPRITEFRAME_COUNT), DATASET_STG, true);
     AllocateStorage((void **)&spr->animations, sizeof(SpriteAnimationEntry) * MIN(animCount, SPRITEANIM_COUNT), DATASET_STG, true);
@@ -79,6 +79,17 @@ struct Animator {
 
 extern SpriteAnimation spriteAnimationList[SPRFILE_COUNT];
 
+#if !RETRO_USE_ORIGINAL_CODE
+#define SPRITEANIM_INDEX_COUNT (0x1000)
+
+extern HashIndexMD5<SPRFILE_COUNT * 2> spriteFileIndex;
+// every loaded animation, grouped by aniFrames
+extern HashIndexMD5<SPRITEANIM_INDEX_COUNT> spriteAnimationIndex;
+
+void BuildSpriteFileIndex();
+void BuildSpriteAnimationIndex();
+#endif
+
 uint16 LoadSpriteAnimation(const char *filename, uint8 scope);
 uint16 CreateSpriteAnimation(const char *filename, uint32 frameCount, uint32 animCount, uint8 scope);
 
@@ -92,6 +103,14 @@ inline uint16 FindSpriteAnimation(uint16 aniFrames, const char *name)
     RETRO_HASH_MD5(hash);
     GEN_HASH_MD5(name, hash);
 
+#if !RETRO_USE_ORIGINAL_CODE
+    if (!spriteAnimationIndex.valid)
+        BuildSpriteAnimationIndex();
+
+    if (!spriteAnimationIndex.full)
+        return spriteAnimationIndex.Find(hash, aniFrames);
+#endif
+
     for (int32 a = 0; a < spr->animCount; ++a) {
         if (HASH_MATCH_MD5(hash, spr->animations[a].hash))
             return a;
@@ -167,6 +186,9 @@ inline void EditSpriteAnimation(uint16 aniFrames, uint16 animID, const char *nam
         if (animID < spr->animCount) {
             SpriteAnimationEntry *anim = &spr->animations[animID];
             GEN_HASH_MD5(name, anim->hash);
+#if !RETRO_USE_ORIGINAL_CODE
+            spriteAnimationIndex.Invalidate();
+#endif
             anim->frameListOffset = frameOffset;
             anim->frameCount      = frameCount;
             anim->animationSpeed  = animSpeed;
@@ -188,6 +210,11 @@ inline void ClearSpriteAnimations()
             spriteAnimationList[s].scope = SCOPE_NONE;
         }
     }
+
+#if !RETRO_USE_ORIGINAL_CODE
+    spriteFileIndex.Invalidate();
+    spriteAnimationIndex.Invalidate();
+#endif
 }
 
 #if RETRO_REV0U
@@ -151,6 +151,9 @@ uint16 RSDK::blendLookupTable[0x20 * 0x100];
 uint16 RSDK::subtractLookupTable[0x20 * 0x100];
 
 GFXSurface RSDK::gfxSurface[SURFACE_COUNT];
+#if !RETRO_USE_ORIGINAL_CODE
+HashIndexMD5<SURFACE_COUNT * 2> RSDK::gfxSurfaceIndex;
+#endif
 
 float RSDK::dpi         = 1;
 int32 RSDK::cameraCount = 0;
@@ -281,7 +284,12 @@ void RSDK::GenerateBlendLookupTable()
 
 void RSDK::InitSystemSurfaces()
 {
+#if !RETRO_USE_ORIGINAL_CODE
+    GEN_HASH_MD5_CONST("TileBuffer", gfxSurface[0].hash);
+    gfxSurfaceIndex.Invalidate();
+#else
     GEN_HASH_MD5("TileBuffer", gfxSurface[0].hash);
+#endif
     gfxSurface[0].scope    = SCOPE_GLOBAL;
     gfxSurface[0].width    = TILE_SIZE;
     gfxSurface[0].height   = TILE_COUNT * TILE_SIZE;
@@ -289,7 +297,11 @@ void RSDK::InitSystemSurfaces()
     gfxSurface[0].pixels   = tilesetPixels;
 
 #if RETRO_REV02
+#if !RETRO_USE_ORIGINAL_CODE
+    GEN_HASH_MD5_CONST("EngineText", gfxSurface[1].hash);
+#else
     GEN_HASH_MD5("EngineText", gfxSurface[1].hash);
+#endif
     gfxSurface[1].scope    = SCOPE_GLOBAL;
     gfxSurface[1].width    = 8;
     gfxSurface[1].height   = 128 * 8;
@@ -240,6 +240,9 @@ extern uint16 blendLookupTable[0x20 * 0x100];
 extern uint16 subtractLookupTable[0x20 * 0x100];
 
 extern GFXSurface gfxSurface[SURFACE_COUNT];
+#if !RETRO_USE_ORIGINAL_CODE
+extern HashIndexMD5<SURFACE_COUNT * 2> gfxSurfaceIndex;
+#endif
 
 extern float dpi;
 extern int32 cameraCount;
@@ -393,6 +396,10 @@ inline void ClearGfxSurfaces()
             gfxSurface[s].scope = SCOPE_NONE;
         }
     }
+
+#if !RETRO_USE_ORIGINAL_CODE
+    gfxSurfaceIndex.Invalidate();
+#endif
 }
 
 #if RETRO_REV0U
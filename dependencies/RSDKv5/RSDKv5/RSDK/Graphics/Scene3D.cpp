@@ -14,6 +14,9 @@ using namespace RSDK;
 #endif
 
 Model RSDK::modelList[MODEL_COUNT];
+#if !RETRO_USE_ORIGINAL_CODE
+HashIndexMD5<MODEL_COUNT * 2> RSDK::modelIndex;
+#endif
 Scene3D RSDK::scene3DList[SCENE3D_COUNT];
 
 ScanEdge RSDK::scanEdgeBuffer[SCREEN_YSIZE * 2];
@@ -397,11 +400,22 @@ uint16 RSDK::LoadMesh(const char *filename, uint8 scope)
     RETRO_HASH_MD5(hash);
     GEN_HASH_MD5(fullFilePath, hash);
 
+#if !RETRO_USE_ORIGINAL_CODE
+    if (!modelIndex.valid) {
+        modelIndex.Reset();
+        for (int32 i = 0; i < MODEL_COUNT; ++i) modelIndex.Add(modelList[i].hash, i);
+    }
+
+    uint16 existing = modelIndex.Find(hash);
+    if (existing != (uint16)-1)
+        return existing;
+#else
     for (int32 i = 0; i < MODEL_COUNT; ++i) {
         if (HASH_MATCH_MD5(hash, modelList[i].hash)) {
             return i;
         }
     }
+#endif
 
     uint16 id = -1;
     for (id = 0; id < MODEL_COUNT; ++id) {
@@ -425,6 +439,9 @@ uint16 RSDK::LoadMesh(const char *filename, uint8 scope)
 
         model->scope = scope;
         HASH_COPY_MD5(model->hash, hash);
+#if !RETRO_USE_ORIGINAL_CODE
+        modelIndex.Add(hash, id);
+#endif
 
         model->flags         = ReadInt8(&info);
         model->faceVertCount = ReadInt8(&info);
@@ -438,6 +455,45 @@ uint16 RSDK::LoadMesh(const char *filename, uint8 scope)
         if (model->flags & MODEL_USECOLOURS)
             AllocateStorage((void **)&model->colors, sizeof(Color) * model->vertCount, DATASET_STG, true);
 
+#if !RETRO_USE_ORIGINAL_CODE
+        if (model->flags & MODEL_USETEXTURES)
+            ReadArrayFloat(&info, (float *)model->texCoords, model->vertCount * 2);
+
+        if (model->flags & MODEL_USECOLOURS)
+            ReadArrayInt32(&info, (int32 *)model->colors, model->vertCount);
+
+        model->indexCount = ReadInt16(&info);
+        AllocateStorage((void **)&model->indices, sizeof(uint16) * model->indexCount, DATASET_STG, true);
+        ReadArrayInt16(&info, (int16 *)model->indices, model->indexCount);
+
+        // each frame's vertices come in as one block of floats, which then get converted to fixed point
+        int32 vertSize    = (model->flags & MODEL_USENORMALS) ? 6 : 3;
+        float *frameVerts = NULL;
+        AllocateStorage((void **)&frameVerts, sizeof(float) * vertSize * model->vertCount, DATASET_TMP, true);
+
+        for (int32 f = 0; f < model->frameCount; ++f) {
+            ReadArrayFloat(&info, frameVerts, vertSize * model->vertCount);
+
+            ModelVertex *vertex = &model->vertices[f * model->vertCount];
+            float *values       = frameVerts;
+            for (int32 v = 0; v < model->vertCount; ++v, ++vertex, values += vertSize) {
+                vertex->x = (int32)(values[0] * 0x100);
+                vertex->y = (int32)(values[1] * 0x100);
+                vertex->z = (int32)(values[2] * 0x100);
+
+                vertex->nx = 0;
+                vertex->ny = 0;
+                vertex->nz = 0;
+                if (model->flags & MODEL_USENORMALS) {
+                    vertex->nx = (int32)(values[3] * 0x10000);
+                    vertex->ny = (int32)(values[4] * 0x10000);
+                    vertex->nz = (int32)(values[5] * 0x10000);
+                }
+            }
+        }
+
+        RemoveStorageEntry((void **)&frameVerts);
+#else
         if (model->flags & MODEL_USETEXTURES) {
             for (int32 v = 0; v < model->vertCount; ++v) {
                 model->texCoords[v].x = ReadSingle(&info);
@@ -471,6 +527,7 @@ uint16 RSDK::LoadMesh(const char *filename, uint8 scope)
                 }
             }
         }
+#endif
 
         CloseFile(&info);
         return id;
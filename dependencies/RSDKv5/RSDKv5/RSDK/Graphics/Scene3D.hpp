@@ -126,6 +126,9 @@ struct Scene3D {
 };
 
 extern Model modelList[MODEL_COUNT];
+#if !RETRO_USE_ORIGINAL_CODE
+extern HashIndexMD5<MODEL_COUNT * 2> modelIndex;
+#endif
 extern Scene3D scene3DList[SCENE3D_COUNT];
 
 extern ScanEdge scanEdgeBuffer[SCREEN_YSIZE * 2];
@@ -232,6 +235,10 @@ inline void Clear3DScenes()
         }
     }
 
+#if !RETRO_USE_ORIGINAL_CODE
+    modelIndex.Invalidate();
+#endif
+
     // Unload 3D Scenes
     for (int32 s = 0; s < SCENE3D_COUNT; ++s) {
         if (scene3DList[s].scope != SCOPE_GLOBAL) {
@@ -13,6 +13,7 @@ const int32 LZ_BITS       = 12;
 const int32 FIRST_CODE    = 4097;
 const int32 NO_SUCH_CODE  = 4098;
 
+#if RETRO_USE_ORIGINAL_CODE
 int32 codeMasks[] = { 0, 1, 3, 7, 15, 31, 63, 127, 255, 511, 1023, 2047, 4095 };
 
 int32 ReadGifCode(ImageGIF *image);
@@ -198,6 +199,168 @@ void ReadGifPictureData(ImageGIF *image, int32 width, int32 height, bool32 inter
     }
     for (int32 h = 0; h < height; ++h) ReadGifLine(image, pixels, width, h * width);
 }
+#else
+// Decodes a GIF's LZW stream into output, interlaced images come out in pass order (see DeinterlaceGif)
+// nothing in here touches the storage allocator or any globals, so it's safe to call from worker threads
+void DecodeGifStream(GifDecoder *decoder, int32 depth, const uint8 *stream, int32 size, uint8 *output, uint32 total)
+{
+    int32 clearCode = 1 << depth;
+    int32 eofCode   = clearCode + 1;
+    int32 nextCode  = eofCode + 1;
+    int32 codeSize  = depth + 1;
+    int32 codeMask  = (1 << codeSize) - 1;
+    int32 prevCode  = NO_SUCH_CODE;
+    uint32 prevPos  = 0;
+    uint32 prevLen  = 0;
+
+    uint64 bitBuffer    = 0;
+    int32 bitCount      = 0;
+    const uint8 *src    = stream;
+    const uint8 *srcEnd = &stream[size];
+
+    uint32 pos = 0;
+    while (pos < total) {
+        if (bitCount < codeSize) {
+            while (bitCount <= 56 && src < srcEnd) {
+                bitBuffer |= (uint64)*src++ << bitCount;
+                bitCount += 8;
+            }
+
+            if (bitCount < codeSize)
+                break;
+        }
+
+        int32 code = (int32)(bitBuffer & codeMask);
+        bitBuffer >>= codeSize;
+        bitCount -= codeSize;
+
+        if (code == clearCode) {
+            nextCode = eofCode + 1;
+            codeSize = depth + 1;
+            codeMask = (1 << codeSize) - 1;
+            prevCode = NO_SUCH_CODE;
+            continue;
+        }
+
+        if (code == eofCode)
+            break;
+
+        uint32 start = pos;
+        if (code < clearCode) {
+            output[pos++] = (uint8)code;
+        }
+        else if (code < nextCode) {
+            uint32 length = MIN(decoder->stringLength[code], total - pos);
+            memcpy(&output[pos], &output[decoder->stringOffset[code]], length);
+            pos += length;
+        }
+        else if (code == nextCode && prevCode != NO_SUCH_CODE) {
+            // KwKwK: the previous string followed by its own first pixel
+            uint32 length = MIN(prevLen, total - pos);
+            memcpy(&output[pos], &output[prevPos], length);
+            pos += length;
+            if (pos < total)
+                output[pos++] = output[prevPos];
+        }
+        else {
+            break; // corrupt stream
+        }
+
+        // the new string is the previous one plus this one's first pixel, which is exactly where they sit in the output
+        if (prevCode != NO_SUCH_CODE && nextCode <= LZ_MAX_CODE) {
+            decoder->stringOffset[nextCode] = prevPos;
+            decoder->stringLength[nextCode] = prevLen + 1;
+
+            if (++nextCode > codeMask && codeSize < LZ_BITS) {
+                ++codeSize;
+                codeMask = (1 << codeSize) - 1;
+            }
+        }
+
+        prevCode = code;
+        prevPos  = start;
+        prevLen  = pos - start;
+    }
+}
+
+void DeinterlaceGif(const uint8 *passes, uint8 *pixels, int32 width, int32 height)
+{
+    int32 initialRows[] = { 0, 4, 2, 1 };
+    int32 rowInc[]      = { 8, 8, 4, 2 };
+
+    const uint8 *row = passes;
+    for (int32 p = 0; p < 4; ++p) {
+        for (int32 y = initialRows[p]; y < height; y += rowInc[p]) {
+            memcpy(&pixels[y * width], row, width);
+            row += width;
+        }
+    }
+}
+
+// pulls every sub-block in so codes can be read from one contiguous stream
+// it's malloc'd rather than taken from the TMP pool, since deferred decodes hold on to it across other allocations
+uint8 *ReadGifStream(FileInfo *info, int32 *size)
+{
+    *size = 0;
+
+    int32 streamSize = info->fileSize - info->readPos;
+    uint8 *stream    = streamSize > 0 ? (uint8 *)malloc(streamSize) : NULL;
+
+    if (stream) {
+        uint8 blockSize = ReadInt8(info);
+        while (blockSize && *size + blockSize <= streamSize) {
+            *size += (int32)ReadBytes(info, &stream[*size], blockSize);
+            blockSize = ReadInt8(info);
+        }
+    }
+
+    return stream;
+}
+
+void ReadGifPictureData(ImageGIF *image, int32 width, int32 height, bool32 interlaced, uint8 *pixels)
+{
+    FileInfo *info = &image->info;
+
+    int32 depth = ReadInt8(info);
+    if (depth < 1 || depth >= LZ_BITS)
+        return;
+
+    int32 size    = 0;
+    uint8 *stream = ReadGifStream(info, &size);
+
+    // LoadSpriteSheet() is batching decodes, so hand the stream over & let a worker do the rest
+    if (image->deferredDecode) {
+        GifDecodeJob *job = image->deferredDecode;
+        job->width        = width;
+        job->height       = height;
+        job->depth        = depth;
+        job->interlaced   = interlaced;
+        job->stream       = stream;
+        job->streamSize   = size;
+        return;
+    }
+
+    BeginProfile(PROFILE_GIF_DECODE);
+
+    // interlaced images are decoded in pass order then shuffled into place, everything else goes straight to the destination
+    uint8 *output = pixels;
+    if (interlaced)
+        AllocateStorage((void **)&output, width * height, DATASET_TMP, false);
+
+    if (output && size) {
+        DecodeGifStream(image->decoder, depth, stream, size, output, width * height);
+
+        if (interlaced)
+            DeinterlaceGif(output, pixels, width, height);
+    }
+
+    if (interlaced)
+        RemoveStorageEntry((void **)&output);
+    free(stream);
+
+    EndProfile(PROFILE_GIF_DECODE);
+}
+#endif
 
 bool32 ImageGIF::Load(const char *fileName, bool32 loadHeader)
 {
@@ -903,6 +1066,154 @@ bool32 RSDK::ImageTGA::Load(const char *fileName, bool32 loadHeader)
 }
 #endif
 
+#if !RETRO_USE_ORIGINAL_CODE
+GifDecodeJob spriteDecodeJobs[SURFACE_COUNT];
+int32 spriteDecodeJobCount  = 0;
+bool32 spriteDecodeBatching = false;
+int32 spriteDecodeWorkerCount = 0;
+ThreadAtomic spriteDecodeQueued; // jobs [0, queued) are ready to be picked up
+ThreadAtomic spriteDecodeNext;   // the next job a worker will take
+ThreadAtomic spriteDecodeClosed;
+#if RETRO_USE_SDL_THREADS
+SDL_Thread *spriteDecodeWorkers[SPRITEDECODE_THREAD_COUNT];
+#else
+std::thread spriteDecodeWorkers[SPRITEDECODE_THREAD_COUNT];
+#endif
+
+void RunGifDecodeJob(GifDecodeJob *job, GifDecoder *decoder)
+{
+    uint64 startTicks = GetProfilerTicks();
+
+    int32 total   = job->width * job->height;
+    job->pixels   = (uint8 *)malloc(total);
+    uint8 *output = job->interlaced ? (uint8 *)malloc(total) : job->pixels;
+
+    if (decoder && job->pixels && output) {
+        memset(output, 0, total);
+        DecodeGifStream(decoder, job->depth, job->stream, job->streamSize, output, total);
+
+        if (job->interlaced)
+            DeinterlaceGif(output, job->pixels, job->width, job->height);
+    }
+
+    if (job->interlaced)
+        free(output);
+
+    job->decoded     = true;
+    job->decodeTicks = GetProfilerTicks() - startTicks;
+}
+
+int32 SpriteDecodeWorker(void *data)
+{
+    GifDecoder *decoder = (GifDecoder *)malloc(sizeof(GifDecoder));
+
+    while (true) {
+        int32 next = GetAtomic(spriteDecodeNext);
+
+        if (next < GetAtomic(spriteDecodeQueued)) {
+            if (SwapAtomic(spriteDecodeNext, next, next + 1))
+                RunGifDecodeJob(&spriteDecodeJobs[next], decoder);
+        }
+        else if (GetAtomic(spriteDecodeClosed)) {
+            // nothing gets queued after the batch closes, so one last look tells us if we're done
+            if (GetAtomic(spriteDecodeNext) >= GetAtomic(spriteDecodeQueued))
+                break;
+        }
+        else {
+            ThreadSleep();
+        }
+    }
+
+    free(decoder);
+    return 0;
+}
+
+void RSDK::BeginSpriteDecodes()
+{
+    WaitForSpriteDecodes();
+
+    spriteDecodeBatching    = engine.spriteDecodeThreads > 0;
+    spriteDecodeJobCount    = 0;
+    spriteDecodeWorkerCount = 0;
+    SetAtomic(spriteDecodeQueued, 0);
+    SetAtomic(spriteDecodeNext, 0);
+    SetAtomic(spriteDecodeClosed, false);
+}
+
+void QueueSpriteDecode(GifDecodeJob *job)
+{
+    ++spriteDecodeJobCount;
+    // AddAtomic is a full barrier, so the job is written out before any worker can see it
+    AddAtomic(spriteDecodeQueued, 1);
+
+    // the pool only starts once there's something to decode
+    if (!spriteDecodeWorkerCount) {
+        for (int32 t = 0; t < engine.spriteDecodeThreads; ++t) {
+#if RETRO_USE_SDL_THREADS
+            spriteDecodeWorkers[t] = SDL_CreateThread((SDL_ThreadFunction)SpriteDecodeWorker, "SpriteDecode", NULL);
+            if (!spriteDecodeWorkers[t])
+                break;
+#else
+            spriteDecodeWorkers[t] = std::thread(SpriteDecodeWorker, (void *)NULL);
+#endif
+            ++spriteDecodeWorkerCount;
+        }
+
+        // no workers means WaitForSpriteDecodes() will do the work itself
+        if (!spriteDecodeWorkerCount)
+            spriteDecodeWorkerCount = -1;
+    }
+}
+
+void RSDK::WaitForSpriteDecodes()
+{
+    if (!spriteDecodeBatching)
+        return;
+
+    spriteDecodeBatching = false;
+    SetAtomic(spriteDecodeClosed, true);
+
+    BeginProfile(PROFILE_SPRITE_DECODE_WAIT);
+    for (int32 t = 0; t < spriteDecodeWorkerCount; ++t) {
+#if RETRO_USE_SDL_THREADS
+        SDL_WaitThread(spriteDecodeWorkers[t], NULL);
+        spriteDecodeWorkers[t] = NULL;
+#else
+        spriteDecodeWorkers[t].join();
+#endif
+    }
+    spriteDecodeWorkerCount = 0;
+    EndProfile(PROFILE_SPRITE_DECODE_WAIT);
+
+    GifDecodeJob *job   = spriteDecodeJobs;
+    GifDecoder *decoder = NULL;
+    for (int32 j = 0; j < spriteDecodeJobCount; ++j, ++job) {
+        if (!job->decoded) {
+            if (!decoder)
+                decoder = (GifDecoder *)malloc(sizeof(GifDecoder));
+            RunGifDecodeJob(job, decoder);
+        }
+
+        // pixels are copied in here rather than decoded in place, since the surface's storage may have moved since it was queued
+        GFXSurface *surface = &gfxSurface[job->surfaceID];
+        if (surface->pixels) {
+            if (job->pixels)
+                memcpy(surface->pixels, job->pixels, job->width * job->height);
+            else
+                memset(surface->pixels, 0, job->width * job->height);
+        }
+
+        AddProfileTicks(PROFILE_GIF_DECODE, job->decodeTicks);
+
+        free(job->stream);
+        free(job->pixels);
+    }
+
+    free(decoder);
+    spriteDecodeJobCount = 0;
+}
+#endif
+
 uint16 RSDK::LoadSpriteSheet(const char *filename, uint8 scope)
 {
     char fullFilePath[0x100];
@@ -914,11 +1225,22 @@ uint16 RSDK::LoadSpriteSheet(const char *filename, uint8 scope)
     RETRO_HASH_MD5(hash);
     GEN_HASH_MD5(filename, hash);
 
+#if !RETRO_USE_ORIGINAL_CODE
+    if (!gfxSurfaceIndex.valid) {
+        gfxSurfaceIndex.Reset();
+        for (int32 i = 0; i < SURFACE_COUNT; ++i) gfxSurfaceIndex.Add(gfxSurface[i].hash, i);
+    }
+
+    uint16 existing = gfxSurfaceIndex.Find(hash);
+    if (existing != (uint16)-1)
+        return existing;
+#else
     for (int32 i = 0; i < SURFACE_COUNT; ++i) {
         if (HASH_MATCH_MD5(gfxSurface[i].hash, hash)) {
             return i;
         }
     }
+#endif
 
     uint16 id = -1;
     for (id = 0; id < SURFACE_COUNT; ++id) {
@@ -939,6 +1261,9 @@ uint16 RSDK::LoadSpriteSheet(const char *filename, uint8 scope)
         surface->height   = image.height;
         surface->lineSize = 0;
         memcpy(surface->hash, hash, 4 * sizeof(int32));
+#if !RETRO_USE_ORIGINAL_CODE
+        gfxSurfaceIndex.Add(hash, id);
+#endif
 
         int32 w = surface->width;
         if (w > 1) {
@@ -963,7 +1288,20 @@ uint16 RSDK::LoadSpriteSheet(const char *filename, uint8 scope)
             AllocateStorage((void **)&surface->pixels, surface->width * surface->height, DATASET_TMP, false);
 #endif
         image.pixels = surface->pixels;
+#if !RETRO_USE_ORIGINAL_CODE
+        GifDecodeJob *job = NULL;
+        if (spriteDecodeBatching && spriteDecodeJobCount < SURFACE_COUNT) {
+            job = &spriteDecodeJobs[spriteDecodeJobCount];
+            memset(job, 0, sizeof(GifDecodeJob));
+            job->surfaceID       = id;
+            image.deferredDecode = job;
+        }
+#endif
         image.Load(NULL, false);
+#if !RETRO_USE_ORIGINAL_CODE
+        if (job && job->stream)
+            QueueSpriteDecode(job);
+#endif
 
 #if RETRO_USE_ORIGINAL_CODE
         image.palette = NULL;
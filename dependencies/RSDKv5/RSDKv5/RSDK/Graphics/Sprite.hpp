@@ -37,6 +37,12 @@ struct Image {
 };
 
 struct GifDecoder {
+#if !RETRO_USE_ORIGINAL_CODE
+    // the string for each code is a run of pixels that's already been decoded, so only its position & length are stored
+    // the first byte (needed for KwKwK codes) is just the first pixel of that run
+    uint32 stringOffset[4096];
+    uint16 stringLength[4096];
+#else
     int32 depth;
     int32 clearCode;
     int32 eofCode;
@@ -56,8 +62,25 @@ struct GifDecoder {
     uint8 stack[4096];
     uint8 suffix[4096];
     uint32 prefix[4096];
+#endif
 };
 
+#if !RETRO_USE_ORIGINAL_CODE
+// A sprite sheet whose LZW stream has been read but not decoded yet, see BeginSpriteDecodes()
+struct GifDecodeJob {
+    uint16 surfaceID;
+    int32 width;
+    int32 height;
+    int32 depth;
+    bool32 interlaced;
+    uint8 *stream;
+    int32 streamSize;
+    uint8 *pixels; // the worker decodes into its own buffer, STG can be defragmented while it's busy
+    bool32 decoded;
+    uint64 decodeTicks;
+};
+#endif
+
 struct ImageGIF : public Image {
     ImageGIF() { AllocateStorage((void **)&decoder, sizeof(GifDecoder), DATASET_TMP, true); }
 #if !RETRO_USE_ORIGINAL_CODE
@@ -67,6 +90,10 @@ struct ImageGIF : public Image {
     bool32 Load(const char *fileName, bool32 loadHeader);
 
     GifDecoder *decoder;
+#if !RETRO_USE_ORIGINAL_CODE
+    // when set, Load() reads the picture's stream into this job instead of decoding it
+    GifDecodeJob *deferredDecode = NULL;
+#endif
 };
 
 #if RETRO_REV02
@@ -118,6 +145,15 @@ struct ImageTGA : public Image {
 #endif
 
 uint16 LoadSpriteSheet(const char *filename, uint8 scope);
+#if !RETRO_USE_ORIGINAL_CODE
+#define SPRITEDECODE_THREAD_COUNT (8)
+
+// While a batch is open LoadSpriteSheet() still hands out slot IDs straight away (in the same order as always)
+// but GIF decoding is left to a pool of worker threads, WaitForSpriteDecodes() then waits for them & fills in the sheets' pixels
+// nothing may read or draw a new sheet until then
+void BeginSpriteDecodes();
+void WaitForSpriteDecodes();
+#endif
 bool32 LoadImage(const char *filename, double displayLength, double fadeSpeed, bool32 (*skipCallback)());
 
 #if RETRO_REV0U
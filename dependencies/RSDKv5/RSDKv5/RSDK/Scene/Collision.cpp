@@ -6,6 +6,10 @@ using namespace RSDK;
 #include "Legacy/CollisionLegacy.cpp"
 #endif
 
+#if RETRO_USE_SSE2
+#include <emmintrin.h>
+#endif
+
 #if RETRO_REV0U
 // Not sure why its 8.0 in v5U, it's 4.0 in v5 and v4, the "fix" is here since 8.0 causes issues with chibi due to his lil hitbox
 #if RETRO_USE_ORIGINAL_CODE
@@ -104,6 +108,286 @@ int32 RSDK::AddDebugHitbox(uint8 type, uint8 dir, Entity *entity, Hitbox *hitbox
 
     return -1;
 }
+
+// flipped copies of the hitboxes are used for the object collision checks, so the callers' hitboxes are never written to
+// (the original code flipped them in place and then flipped them back)
+static inline void FlipObjectHitbox(uint8 direction, const Hitbox *src, Hitbox *dst)
+{
+    bool32 flipX = direction & FLIP_X;
+    bool32 flipY = direction & FLIP_Y;
+    int16 left   = src->left;
+    int16 top    = src->top;
+    int16 right  = src->right;
+    int16 bottom = src->bottom;
+
+    dst->left   = flipX ? -right : left;
+    dst->top    = flipY ? -bottom : top;
+    dst->right  = flipX ? -left : right;
+    dst->bottom = flipY ? -top : bottom;
+}
+
+static inline void FlipObjectHitboxes(uint8 direction, Hitbox **thisHitbox, Hitbox *thisBox, Hitbox **otherHitbox, Hitbox *otherBox)
+{
+    if (*thisHitbox == *otherHitbox) {
+        // passing the same hitbox twice meant it got flipped & then flipped back, and any adjustments to one applied to both
+        *thisBox     = **thisHitbox;
+        *thisHitbox  = thisBox;
+        *otherHitbox = thisBox;
+    }
+    else {
+        FlipObjectHitbox(direction, *thisHitbox, thisBox);
+        FlipObjectHitbox(direction, *otherHitbox, otherBox);
+        *thisHitbox  = thisBox;
+        *otherHitbox = otherBox;
+    }
+}
+
+CollisionLayerCache RSDK::collisionLayerCache;
+
+void RSDK::ResetCollisionLayerCache()
+{
+    CollisionLayerCache *cache = &collisionLayerCache;
+
+    free(cache->solidLayers[0]);
+    cache->solidLayers[0] = NULL;
+    cache->solidLayers[1] = NULL;
+    cache->owners[0]      = NULL;
+    cache->owners[1]      = NULL;
+
+    cache->layers   = 0;
+    cache->excluded = 0;
+    cache->valid    = false;
+}
+
+static inline void UpdateCollisionCacheSolids(int32 x, int32 y)
+{
+    CollisionLayerCache *cache = &collisionLayerCache;
+
+    uint8 solidA = 0;
+    uint8 solidB = 0;
+    for (int32 l = 0; l < LAYER_COUNT; ++l) {
+        TileLayer *layer = &tileLayers[l];
+        if ((cache->layers & (1 << l)) && x < layer->xsize && y < layer->ysize) {
+            uint16 tile = layer->layout[x + (y << layer->widthShift)];
+            if (tile < 0xFFFF) {
+                if (tile & ((1 << 12) | (1 << 13)))
+                    solidA |= 1 << l;
+                if (tile & ((1 << 14) | (1 << 15)))
+                    solidB |= 1 << l;
+            }
+        }
+    }
+
+    cache->solidLayers[0][x + (y << cache->widthShift)] = solidA;
+    cache->solidLayers[1][x + (y << cache->widthShift)] = solidB;
+}
+
+static inline uint8 GetCollisionCacheOwner(uint8 layers)
+{
+    if (!layers)
+        return COLLISIONCACHE_EMPTY;
+
+    if (layers & (layers - 1))
+        return COLLISIONCACHE_MIXED;
+
+    uint8 id = 0;
+    while (!(layers & (1 << id))) ++id;
+    return id;
+}
+
+static inline void UpdateCollisionCacheOwners(int32 x, int32 y)
+{
+    CollisionLayerCache *cache = &collisionLayerCache;
+
+    int32 left   = MAX(x - COLLISIONCACHE_RANGE, 0);
+    int32 top    = MAX(y - COLLISIONCACHE_RANGE, 0);
+    int32 right  = MIN(x + COLLISIONCACHE_RANGE, cache->width - 1);
+    int32 bottom = MIN(y + COLLISIONCACHE_RANGE, cache->height - 1);
+
+    for (int32 p = 0; p < 2; ++p) {
+        uint8 layers = 0;
+        for (int32 ty = top; ty <= bottom; ++ty) {
+            uint8 *solid = &cache->solidLayers[p][ty << cache->widthShift];
+            for (int32 tx = left; tx <= right; ++tx) layers |= solid[tx];
+        }
+
+        cache->owners[p][x + (y << cache->widthShift)] = GetCollisionCacheOwner(layers);
+    }
+}
+
+static void BuildCollisionLayerCache()
+{
+    CollisionLayerCache *cache = &collisionLayerCache;
+
+    free(cache->solidLayers[0]);
+    cache->solidLayers[0] = NULL;
+    cache->valid          = false;
+
+    cache->width  = 0;
+    cache->height = 0;
+    for (int32 l = 0; l < LAYER_COUNT; ++l) {
+        TileLayer *layer = &tileLayers[l];
+        if (cache->layers & (1 << l)) {
+            cache->width  = MAX(cache->width, (int32)layer->xsize);
+            cache->height = MAX(cache->height, (int32)layer->ysize);
+        }
+    }
+
+    cache->layerCount = 0;
+    for (int32 l = 0; l < LAYER_COUNT; ++l) {
+        if (cache->layers & (1 << l))
+            cache->layerIDs[cache->layerCount++] = l;
+    }
+
+    // layers without any tiles, sensors will just fall outside of the cache
+    if (!cache->width || !cache->height) {
+        cache->valid = true;
+        return;
+    }
+
+    cache->widthShift = 0;
+    while ((1 << cache->widthShift) < cache->width) cache->widthShift++;
+
+    // solids & owners for both planes, plus a row-merged copy of the solids to build the owners from
+    size_t cellCount = (size_t)cache->height << cache->widthShift;
+    uint8 *buffer    = (uint8 *)malloc(cellCount * 5);
+    if (!buffer) {
+        // nothing gets merged then, every sensor goes through its layers like usual
+        cache->excluded |= cache->layers;
+        cache->layers = 0;
+        return;
+    }
+
+    cache->solidLayers[0] = buffer;
+    cache->solidLayers[1] = buffer + cellCount;
+    cache->owners[0]      = buffer + cellCount * 2;
+    cache->owners[1]      = buffer + cellCount * 3;
+    uint8 *rows           = buffer + cellCount * 4;
+
+    for (int32 y = 0; y < cache->height; ++y) {
+        for (int32 x = 0; x < cache->width; ++x) UpdateCollisionCacheSolids(x, y);
+    }
+
+    for (int32 p = 0; p < 2; ++p) {
+        for (int32 y = 0; y < cache->height; ++y) {
+            uint8 *solid = &cache->solidLayers[p][y << cache->widthShift];
+            uint8 *row   = &rows[y << cache->widthShift];
+            for (int32 x = 0; x < cache->width; ++x) {
+                uint8 layers = 0;
+                for (int32 tx = MAX(x - COLLISIONCACHE_RANGE, 0); tx <= MIN(x + COLLISIONCACHE_RANGE, cache->width - 1); ++tx) layers |= solid[tx];
+                row[x] = layers;
+            }
+        }
+
+        for (int32 y = 0; y < cache->height; ++y) {
+            uint8 *owner = &cache->owners[p][y << cache->widthShift];
+            int32 top    = MAX(y - COLLISIONCACHE_RANGE, 0);
+            int32 bottom = MIN(y + COLLISIONCACHE_RANGE, cache->height - 1);
+            for (int32 x = 0; x < cache->width; ++x) {
+                uint8 layers = 0;
+                for (int32 ty = top; ty <= bottom; ++ty) layers |= rows[x + (ty << cache->widthShift)];
+                owner[x] = GetCollisionCacheOwner(layers);
+            }
+        }
+    }
+
+    cache->valid = true;
+}
+
+void RSDK::UpdateCollisionLayerCache(uint16 layerID, int32 tileX, int32 tileY, int32 countX, int32 countY)
+{
+    CollisionLayerCache *cache = &collisionLayerCache;
+    if (!cache->valid || layerID >= LAYER_COUNT || !(cache->layers & (1 << layerID)))
+        return;
+
+    int32 left   = MAX(tileX, 0);
+    int32 top    = MAX(tileY, 0);
+    int32 right  = MIN(tileX + countX, cache->width);
+    int32 bottom = MIN(tileY + countY, cache->height);
+    if (left >= right || top >= bottom)
+        return;
+
+    for (int32 y = top; y < bottom; ++y) {
+        for (int32 x = left; x < right; ++x) UpdateCollisionCacheSolids(x, y);
+    }
+
+    left   = MAX(left - COLLISIONCACHE_RANGE, 0);
+    top    = MAX(top - COLLISIONCACHE_RANGE, 0);
+    right  = MIN(right + COLLISIONCACHE_RANGE, cache->width);
+    bottom = MIN(bottom + COLLISIONCACHE_RANGE, cache->height);
+    for (int32 y = top; y < bottom; ++y) {
+        for (int32 x = left; x < right; ++x) UpdateCollisionCacheOwners(x, y);
+    }
+}
+
+// merges any layers in 'layers' that aren't in the cache yet, returns false if the cache can't be used for them
+static bool32 RefreshCollisionLayerCache(uint16 layers)
+{
+    CollisionLayerCache *cache = &collisionLayerCache;
+
+    if (layers & cache->excluded)
+        return false;
+
+    for (int32 l = 0; l < LAYER_COUNT; ++l) {
+        if ((layers & (1 << l)) && !(cache->layers & (1 << l))) {
+            TileLayer *layer = &tileLayers[l];
+            if (!cache->layers)
+                cache->position = layer->position;
+
+            if (layer->position.x == cache->position.x && layer->position.y == cache->position.y) {
+                cache->layers |= 1 << l;
+                cache->valid = false;
+            }
+            else {
+                cache->excluded |= 1 << l;
+            }
+        }
+    }
+
+    if (!cache->valid && cache->layers)
+        BuildCollisionLayerCache();
+
+    return cache->valid && !(layers & cache->excluded);
+}
+
+// the layers a sensor at posX, posY actually has to check
+// if only one merged layer has solid tiles around it, every other layer would've been skipped over anyways
+static inline uint16 GetSensorLayers(int32 posX, int32 posY)
+{
+    CollisionLayerCache *cache = &collisionLayerCache;
+    uint16 layers              = collisionEntity->collisionLayers;
+
+    if (!cache->valid || (layers & ~cache->layers & ((1 << LAYER_COUNT) - 1))) {
+        if (!RefreshCollisionLayerCache(layers))
+            return layers;
+    }
+
+    // merged layers aren't expected to move, any that do get dropped from the cache
+    for (int32 i = 0; i < cache->layerCount; ++i) {
+        int32 l          = cache->layerIDs[i];
+        TileLayer *layer = &tileLayers[l];
+        if (layer->position.x != cache->position.x || layer->position.y != cache->position.y) {
+            cache->layers &= ~(1 << l);
+            cache->excluded |= 1 << l;
+            cache->valid = false;
+            return layers;
+        }
+    }
+
+    int32 x = (posX - cache->position.x) >> 4;
+    int32 y = (posY - cache->position.y) >> 4;
+    if (x < 0 || x >= cache->width || y < 0 || y >= cache->height)
+        return layers;
+
+    uint8 owner = cache->owners[collisionEntity->collisionPlane][x + (y << cache->widthShift)];
+    if (owner == COLLISIONCACHE_MIXED)
+        return layers;
+
+    if (owner == COLLISIONCACHE_EMPTY)
+        return 0;
+
+    return layers & (1 << owner);
+}
 #endif
 
 #if RETRO_REV0U || RETRO_USE_MOD_LOADER
@@ -208,10 +492,18 @@ void RSDK::CopyCollisionMask(uint16 dst, uint16 src, uint8 cPlane, uint8 cMode)
 
 bool32 RSDK::CheckObjectCollisionTouch(Entity *thisEntity, Hitbox *thisHitbox, Entity *otherEntity, Hitbox *otherHitbox)
 {
+#if RETRO_USE_ORIGINAL_CODE
     int32 store = 0;
+#endif
     if (!thisEntity || !otherEntity || !thisHitbox || !otherHitbox)
         return false;
 
+#if !RETRO_USE_ORIGINAL_CODE
+    Hitbox *thisSource  = thisHitbox;
+    Hitbox *otherSource = otherHitbox;
+    Hitbox thisBox, otherBox;
+    FlipObjectHitboxes(thisEntity->direction, &thisHitbox, &thisBox, &otherHitbox, &otherBox);
+#else
     if ((thisEntity->direction & FLIP_X) == FLIP_X) {
         store             = -thisHitbox->left;
         thisHitbox->left  = -thisHitbox->right;
@@ -230,6 +522,7 @@ bool32 RSDK::CheckObjectCollisionTouch(Entity *thisEntity, Hitbox *thisHitbox, E
         otherHitbox->top    = -otherHitbox->bottom;
         otherHitbox->bottom = store;
     }
+#endif
 
     int32 thisIX  = FROM_FIXED(thisEntity->position.x);
     int32 thisIY  = FROM_FIXED(thisEntity->position.y);
@@ -239,6 +532,7 @@ bool32 RSDK::CheckObjectCollisionTouch(Entity *thisEntity, Hitbox *thisHitbox, E
     bool32 collided = thisIX + thisHitbox->left < otherIX + otherHitbox->right && thisIX + thisHitbox->right > otherIX + otherHitbox->left
                       && thisIY + thisHitbox->top < otherIY + otherHitbox->bottom && thisIY + thisHitbox->bottom > otherIY + otherHitbox->top;
 
+#if RETRO_USE_ORIGINAL_CODE
     if ((thisEntity->direction & FLIP_X) == FLIP_X) {
         store             = -thisHitbox->left;
         thisHitbox->left  = -thisHitbox->right;
@@ -257,11 +551,12 @@ bool32 RSDK::CheckObjectCollisionTouch(Entity *thisEntity, Hitbox *thisHitbox, E
         otherHitbox->top    = -otherHitbox->bottom;
         otherHitbox->bottom = store;
     }
+#endif
 
 #if !RETRO_USE_ORIGINAL_CODE
     if (showHitboxes) {
-        int32 thisHitboxID  = RSDK::AddDebugHitbox(H_TYPE_TOUCH, thisEntity->direction, thisEntity, thisHitbox);
-        int32 otherHitboxID = RSDK::AddDebugHitbox(H_TYPE_TOUCH, thisEntity->direction, otherEntity, otherHitbox);
+        int32 thisHitboxID  = RSDK::AddDebugHitbox(H_TYPE_TOUCH, thisEntity->direction, thisEntity, thisSource);
+        int32 otherHitboxID = RSDK::AddDebugHitbox(H_TYPE_TOUCH, thisEntity->direction, otherEntity, otherSource);
 
         if (thisHitboxID >= 0 && collided)
             debugHitboxList[thisHitboxID].collision |= 1 << (collided - 1);
@@ -273,6 +568,117 @@ bool32 RSDK::CheckObjectCollisionTouch(Entity *thisEntity, Hitbox *thisHitbox, E
     return collided;
 }
 
+#if !RETRO_USE_ORIGINAL_CODE
+uint32 RSDK::CheckObjectCollisionTouchBatch(Entity *thisEntity, Hitbox *thisHitbox, Entity **otherEntities, Hitbox **otherHitboxes, int32 count)
+{
+    if (!thisEntity || !thisHitbox || !otherEntities || !otherHitboxes)
+        return 0;
+
+    if (count > 32)
+        count = 32;
+
+    Hitbox thisBox;
+    FlipObjectHitbox(thisEntity->direction, thisHitbox, &thisBox);
+
+    int32 thisIX     = FROM_FIXED(thisEntity->position.x);
+    int32 thisIY     = FROM_FIXED(thisEntity->position.y);
+    int32 thisLeft   = thisIX + thisBox.left;
+    int32 thisTop    = thisIY + thisBox.top;
+    int32 thisRight  = thisIX + thisBox.right;
+    int32 thisBottom = thisIY + thisBox.bottom;
+
+    uint32 collided = 0;
+    for (int32 base = 0; base < count; base += 4) {
+        // lanes that don't get tested here (empty slots, NULLs or a shared hitbox) get an inside-out box so the compare always fails
+        int32 otherLeft[4], otherTop[4], otherRight[4], otherBottom[4];
+        for (int32 l = 0; l < 4; ++l) {
+            otherLeft[l]   = 0x7FFFFFFF;
+            otherTop[l]    = 0x7FFFFFFF;
+            otherRight[l]  = -0x7FFFFFFF - 1;
+            otherBottom[l] = -0x7FFFFFFF - 1;
+
+            if (base + l >= count)
+                continue;
+
+            Entity *other  = otherEntities[base + l];
+            Hitbox *hitbox = otherHitboxes[base + l];
+            if (!other || !hitbox)
+                continue;
+
+            if (hitbox == thisHitbox) {
+                // the same hitbox on both sides is never flipped, see FlipObjectHitboxes
+                if (CheckObjectCollisionTouch(thisEntity, thisHitbox, other, hitbox))
+                    collided |= 1u << (base + l);
+                continue;
+            }
+
+            Hitbox otherBox;
+            FlipObjectHitbox(thisEntity->direction, hitbox, &otherBox);
+
+            int32 otherIX  = FROM_FIXED(other->position.x);
+            int32 otherIY  = FROM_FIXED(other->position.y);
+            otherLeft[l]   = otherIX + otherBox.left;
+            otherTop[l]    = otherIY + otherBox.top;
+            otherRight[l]  = otherIX + otherBox.right;
+            otherBottom[l] = otherIY + otherBox.bottom;
+        }
+
+#if RETRO_USE_SSE2
+        __m128i hit = _mm_and_si128(_mm_cmplt_epi32(_mm_set1_epi32(thisLeft), _mm_loadu_si128((const __m128i *)otherRight)),
+                                    _mm_cmpgt_epi32(_mm_set1_epi32(thisRight), _mm_loadu_si128((const __m128i *)otherLeft)));
+        hit         = _mm_and_si128(hit, _mm_cmplt_epi32(_mm_set1_epi32(thisTop), _mm_loadu_si128((const __m128i *)otherBottom)));
+        hit         = _mm_and_si128(hit, _mm_cmpgt_epi32(_mm_set1_epi32(thisBottom), _mm_loadu_si128((const __m128i *)otherTop)));
+        collided |= (uint32)_mm_movemask_ps(_mm_castsi128_ps(hit)) << base;
+#elif RETRO_USE_ALTIVEC
+        union TouchLanes {
+            __vector signed int v;
+            int32 lanes[4];
+        } left, top, right, bottom, self;
+
+        memcpy(left.lanes, otherLeft, sizeof(left.lanes));
+        memcpy(top.lanes, otherTop, sizeof(top.lanes));
+        memcpy(right.lanes, otherRight, sizeof(right.lanes));
+        memcpy(bottom.lanes, otherBottom, sizeof(bottom.lanes));
+
+        self.lanes[0] = thisLeft;
+        self.lanes[1] = thisTop;
+        self.lanes[2] = thisRight;
+        self.lanes[3] = thisBottom;
+
+        __vector __bool int hit = vec_and(vec_cmplt(vec_splat(self.v, 0), right.v), vec_cmpgt(vec_splat(self.v, 2), left.v));
+        hit                     = vec_and(hit, vec_cmplt(vec_splat(self.v, 1), bottom.v));
+        hit                     = vec_and(hit, vec_cmpgt(vec_splat(self.v, 3), top.v));
+
+        self.v = (__vector signed int)hit;
+        for (int32 l = 0; l < 4; ++l) collided |= (self.lanes[l] & 1) << (base + l);
+#else
+        for (int32 l = 0; l < 4; ++l) {
+            if (thisLeft < otherRight[l] && thisRight > otherLeft[l] && thisTop < otherBottom[l] && thisBottom > otherTop[l])
+                collided |= 1u << (base + l);
+        }
+#endif
+    }
+
+    if (showHitboxes) {
+        for (int32 i = 0; i < count; ++i) {
+            // NULLs aren't recorded, and shared hitboxes were already recorded by CheckObjectCollisionTouch
+            if (!otherEntities[i] || !otherHitboxes[i] || otherHitboxes[i] == thisHitbox)
+                continue;
+
+            int32 thisHitboxID  = RSDK::AddDebugHitbox(H_TYPE_TOUCH, thisEntity->direction, thisEntity, thisHitbox);
+            int32 otherHitboxID = RSDK::AddDebugHitbox(H_TYPE_TOUCH, thisEntity->direction, otherEntities[i], otherHitboxes[i]);
+
+            if (thisHitboxID >= 0 && ((collided >> i) & 1))
+                debugHitboxList[thisHitboxID].collision |= 1;
+            if (otherHitboxID >= 0 && ((collided >> i) & 1))
+                debugHitboxList[otherHitboxID].collision |= 1;
+        }
+    }
+
+    return collided;
+}
+#endif
+
 uint8 RSDK::CheckObjectCollisionBox(Entity *thisEntity, Hitbox *thisHitbox, Entity *otherEntity, Hitbox *otherHitbox, bool32 setValues)
 {
     if (!thisEntity || !otherEntity || !thisHitbox || !otherHitbox)
@@ -284,6 +690,12 @@ uint8 RSDK::CheckObjectCollisionBox(Entity *thisEntity, Hitbox *thisHitbox, Enti
     int32 collideX = otherEntity->position.x;
     int32 collideY = otherEntity->position.y;
 
+#if !RETRO_USE_ORIGINAL_CODE
+    Hitbox *thisSource  = thisHitbox;
+    Hitbox *otherSource = otherHitbox;
+    Hitbox thisBox, otherBox;
+    FlipObjectHitboxes(thisEntity->direction, &thisHitbox, &thisBox, &otherHitbox, &otherBox);
+#else
     if ((thisEntity->direction & FLIP_X) == FLIP_X) {
         int32 store       = -thisHitbox->left;
         thisHitbox->left  = -thisHitbox->right;
@@ -303,6 +715,7 @@ uint8 RSDK::CheckObjectCollisionBox(Entity *thisEntity, Hitbox *thisHitbox, Enti
         otherHitbox->top    = -otherHitbox->bottom;
         otherHitbox->bottom = store;
     }
+#endif
 
     int32 thisIX  = FROM_FIXED(thisEntity->position.x);
     int32 thisIY  = FROM_FIXED(thisEntity->position.y);
@@ -351,6 +764,7 @@ uint8 RSDK::CheckObjectCollisionBox(Entity *thisEntity, Hitbox *thisHitbox, Enti
     otherHitbox->left--;
     otherHitbox->right++;
 
+#if RETRO_USE_ORIGINAL_CODE
     if ((thisEntity->direction & FLIP_X) == FLIP_X) {
         int32 store       = -thisHitbox->left;
         thisHitbox->left  = -thisHitbox->right;
@@ -370,6 +784,7 @@ uint8 RSDK::CheckObjectCollisionBox(Entity *thisEntity, Hitbox *thisHitbox, Enti
         otherHitbox->top    = -otherHitbox->bottom;
         otherHitbox->bottom = store;
     }
+#endif
 
     uint8 side = C_NONE;
 
@@ -474,8 +889,8 @@ uint8 RSDK::CheckObjectCollisionBox(Entity *thisEntity, Hitbox *thisHitbox, Enti
 
 #if !RETRO_USE_ORIGINAL_CODE
     if (showHitboxes) {
-        int32 thisHitboxID  = RSDK::AddDebugHitbox(H_TYPE_BOX, thisEntity->direction, thisEntity, thisHitbox);
-        int32 otherHitboxID = RSDK::AddDebugHitbox(H_TYPE_BOX, thisEntity->direction, otherEntity, otherHitbox);
+        int32 thisHitboxID  = RSDK::AddDebugHitbox(H_TYPE_BOX, thisEntity->direction, thisEntity, thisSource);
+        int32 otherHitboxID = RSDK::AddDebugHitbox(H_TYPE_BOX, thisEntity->direction, otherEntity, otherSource);
 
         if (thisHitboxID >= 0 && side)
             debugHitboxList[thisHitboxID].collision |= 1 << (side - 1);
@@ -488,12 +903,20 @@ uint8 RSDK::CheckObjectCollisionBox(Entity *thisEntity, Hitbox *thisHitbox, Enti
 
 bool32 RSDK::CheckObjectCollisionPlatform(Entity *thisEntity, Hitbox *thisHitbox, Entity *otherEntity, Hitbox *otherHitbox, bool32 setValues)
 {
-    int32 store     = 0;
+#if RETRO_USE_ORIGINAL_CODE
+    int32 store = 0;
+#endif
     bool32 collided = false;
 
     if (!thisEntity || !otherEntity || !thisHitbox || !otherHitbox)
         return false;
 
+#if !RETRO_USE_ORIGINAL_CODE
+    Hitbox *thisSource  = thisHitbox;
+    Hitbox *otherSource = otherHitbox;
+    Hitbox thisBox, otherBox;
+    FlipObjectHitboxes(thisEntity->direction, &thisHitbox, &thisBox, &otherHitbox, &otherBox);
+#else
     if ((thisEntity->direction & FLIP_X) == FLIP_X) {
         store             = -thisHitbox->left;
         thisHitbox->left  = -thisHitbox->right;
@@ -512,6 +935,7 @@ bool32 RSDK::CheckObjectCollisionPlatform(Entity *thisEntity, Hitbox *thisHitbox
         otherHitbox->top    = -otherHitbox->bottom;
         otherHitbox->bottom = store;
     }
+#endif
 
     int32 thisIX  = FROM_FIXED(thisEntity->position.x);
     int32 thisIY  = FROM_FIXED(thisEntity->position.y);
@@ -565,6 +989,7 @@ bool32 RSDK::CheckObjectCollisionPlatform(Entity *thisEntity, Hitbox *thisHitbox
     }
 #endif
 
+#if RETRO_USE_ORIGINAL_CODE
     if ((thisEntity->direction & FLIP_X) == FLIP_X) {
         store             = -thisHitbox->left;
         thisHitbox->left  = -thisHitbox->right;
@@ -584,11 +1009,12 @@ bool32 RSDK::CheckObjectCollisionPlatform(Entity *thisEntity, Hitbox *thisHitbox
         otherHitbox->top    = -otherHitbox->bottom;
         otherHitbox->bottom = store;
     }
+#endif
 
 #if !RETRO_USE_ORIGINAL_CODE
     if (showHitboxes) {
-        int32 thisHitboxID  = RSDK::AddDebugHitbox(H_TYPE_PLAT, thisEntity->direction, thisEntity, thisHitbox);
-        int32 otherHitboxID = RSDK::AddDebugHitbox(H_TYPE_PLAT, thisEntity->direction, otherEntity, otherHitbox);
+        int32 thisHitboxID  = RSDK::AddDebugHitbox(H_TYPE_PLAT, thisEntity->direction, thisEntity, thisSource);
+        int32 otherHitboxID = RSDK::AddDebugHitbox(H_TYPE_PLAT, thisEntity->direction, otherEntity, otherSource);
 #if RETRO_REV0U
         if (otherEntity->tileCollisions == TILECOLLISION_UP) {
 
@@ -2176,8 +2602,14 @@ void RSDK::FindFloorPosition(CollisionSensor *sensor)
 
     int32 startY = posY;
 
+#if !RETRO_USE_ORIGINAL_CODE
+    uint16 sensorLayers = GetSensorLayers(posX, posY);
+#else
+    uint16 sensorLayers = collisionEntity->collisionLayers;
+#endif
+
     for (int32 l = 0, layerID = 1; l < LAYER_COUNT; ++l, layerID <<= 1) {
-        if (collisionEntity->collisionLayers & layerID) {
+        if (sensorLayers & layerID) {
             TileLayer *layer = &tileLayers[l];
             int32 colX       = posX - layer->position.x;
             int32 colY       = posY - layer->position.y;
@@ -2237,8 +2669,14 @@ void RSDK::FindLWallPosition(CollisionSensor *sensor)
 
     int32 startX = posX;
 
+#if !RETRO_USE_ORIGINAL_CODE
+    uint16 sensorLayers = GetSensorLayers(posX, posY);
+#else
+    uint16 sensorLayers = collisionEntity->collisionLayers;
+#endif
+
     for (int32 l = 0, layerID = 1; l < LAYER_COUNT; ++l, layerID <<= 1) {
-        if (collisionEntity->collisionLayers & layerID) {
+        if (sensorLayers & layerID) {
             TileLayer *layer = &tileLayers[l];
             int32 colX       = posX - layer->position.x;
             int32 colY       = posY - layer->position.y;
@@ -2293,8 +2731,14 @@ void RSDK::FindRoofPosition(CollisionSensor *sensor)
 
     int32 startY = posY;
 
+#if !RETRO_USE_ORIGINAL_CODE
+    uint16 sensorLayers = GetSensorLayers(posX, posY);
+#else
+    uint16 sensorLayers = collisionEntity->collisionLayers;
+#endif
+
     for (int32 l = 0, layerID = 1; l < LAYER_COUNT; ++l, layerID <<= 1) {
-        if (collisionEntity->collisionLayers & layerID) {
+        if (sensorLayers & layerID) {
             TileLayer *layer = &tileLayers[l];
             int32 colX       = posX - layer->position.x;
             int32 colY       = posY - layer->position.y;
@@ -2342,8 +2786,14 @@ void RSDK::FindRWallPosition(CollisionSensor *sensor)
 
     int32 startX = posX;
 
+#if !RETRO_USE_ORIGINAL_CODE
+    uint16 sensorLayers = GetSensorLayers(posX, posY);
+#else
+    uint16 sensorLayers = collisionEntity->collisionLayers;
+#endif
+
     for (int32 l = 0, layerID = 1; l < LAYER_COUNT; ++l, layerID <<= 1) {
-        if (collisionEntity->collisionLayers & layerID) {
+        if (sensorLayers & layerID) {
             TileLayer *layer = &tileLayers[l];
             int32 colX       = posX - layer->position.x;
             int32 colY       = posY - layer->position.y;
@@ -2403,8 +2853,14 @@ void RSDK::FloorCollision(CollisionSensor *sensor)
     int32 collidePos   = 0x7FFFFFFF;
 #endif
 
+#if !RETRO_USE_ORIGINAL_CODE
+    uint16 sensorLayers = GetSensorLayers(posX, posY);
+#else
+    uint16 sensorLayers = collisionEntity->collisionLayers;
+#endif
+
     for (int32 l = 0, layerID = 1; l < LAYER_COUNT; ++l, layerID <<= 1) {
-        if (collisionEntity->collisionLayers & layerID) {
+        if (sensorLayers & layerID) {
             TileLayer *layer = &tileLayers[l];
             int32 colX       = posX - layer->position.x;
             int32 colY       = posY - layer->position.y;
@@ -2476,8 +2932,14 @@ void RSDK::LWallCollision(CollisionSensor *sensor)
 
     int32 solid = collisionEntity->collisionPlane ? (1 << 15) : (1 << 13);
 
+#if !RETRO_USE_ORIGINAL_CODE
+    uint16 sensorLayers = GetSensorLayers(posX, posY);
+#else
+    uint16 sensorLayers = collisionEntity->collisionLayers;
+#endif
+
     for (int32 l = 0, layerID = 1; l < LAYER_COUNT; ++l, layerID <<= 1) {
-        if (collisionEntity->collisionLayers & layerID) {
+        if (sensorLayers & layerID) {
             TileLayer *layer = &tileLayers[l];
             int32 colX       = posX - layer->position.x;
             int32 colY       = posY - layer->position.y;
@@ -2529,8 +2991,14 @@ void RSDK::RoofCollision(CollisionSensor *sensor)
     int32 collidePos   = -1;
 #endif
 
+#if !RETRO_USE_ORIGINAL_CODE
+    uint16 sensorLayers = GetSensorLayers(posX, posY);
+#else
+    uint16 sensorLayers = collisionEntity->collisionLayers;
+#endif
+
     for (int32 l = 0, layerID = 1; l < LAYER_COUNT; ++l, layerID <<= 1) {
-        if (collisionEntity->collisionLayers & layerID) {
+        if (sensorLayers & layerID) {
             TileLayer *layer = &tileLayers[l];
             int32 colX       = posX - layer->position.x;
             int32 colY       = posY - layer->position.y;
@@ -2602,8 +3070,14 @@ void RSDK::RWallCollision(CollisionSensor *sensor)
 
     int32 solid = collisionEntity->collisionPlane ? (1 << 15) : (1 << 13);
 
+#if !RETRO_USE_ORIGINAL_CODE
+    uint16 sensorLayers = GetSensorLayers(posX, posY);
+#else
+    uint16 sensorLayers = collisionEntity->collisionLayers;
+#endif
+
     for (int32 l = 0, layerID = 1; l < LAYER_COUNT; ++l, layerID <<= 1) {
-        if (collisionEntity->collisionLayers & layerID) {
+        if (sensorLayers & layerID) {
             TileLayer *layer = &tileLayers[l];
             int32 colX       = posX - layer->position.x;
             int32 colY       = posY - layer->position.y;
@@ -44,6 +44,31 @@ extern int32 debugHitboxCount;
 extern DebugHitboxInfo debugHitboxList[DEBUG_HITBOX_COUNT];
 
 int32 AddDebugHitbox(uint8 type, uint8 dir, Entity *entity, Hitbox *hitbox);
+
+#define COLLISIONCACHE_RANGE (2)    // furthest any sensor looks from the tile it's in
+#define COLLISIONCACHE_EMPTY (0xFE) // no merged layer has solid tiles nearby
+#define COLLISIONCACHE_MIXED (0xFF) // more than one merged layer has solid tiles nearby
+
+// merged view of the (static) layers entities collide with
+// for every tile & collision plane it stores the only layer with solid tiles within COLLISIONCACHE_RANGE of it,
+// so a sensor there only has to check that layer (or none), instead of every layer in collisionLayers
+struct CollisionLayerCache {
+    uint16 layers;   // layers merged into the cache, added as entities ask for them
+    uint16 excluded; // layers that moved or sit somewhere else, sensors using these check every layer like usual
+    bool32 valid;
+    uint8 layerIDs[LAYER_COUNT];
+    uint8 layerCount;
+    Vector2 position;
+    int32 width;
+    int32 height;
+    uint8 widthShift;
+    uint8 *solidLayers[2]; // which merged layers have a solid tile in each tile, per plane
+    uint8 *owners[2];      // which merged layer has solid tiles near each tile (or COLLISIONCACHE_EMPTY/MIXED), per plane
+};
+
+extern CollisionLayerCache collisionLayerCache;
+
+void ResetCollisionLayerCache();
 #endif
 
 extern int32 collisionTolerance;
@@ -97,6 +122,10 @@ inline void GetCollisionInfo(CollisionMask **masks, TileInfo **tiles)
 #endif
 
 bool32 CheckObjectCollisionTouch(Entity *thisEntity, Hitbox *thisHitbox, Entity *otherEntity, Hitbox *otherHitbox);
+#if !RETRO_USE_ORIGINAL_CODE
+// CheckObjectCollisionTouch against up to 32 entity/hitbox pairs at once, bit N of the result is set if pair N collided
+uint32 CheckObjectCollisionTouchBatch(Entity *thisEntity, Hitbox *thisHitbox, Entity **otherEntities, Hitbox **otherHitboxes, int32 count);
+#endif
 inline bool32 CheckObjectCollisionCircle(Entity *thisEntity, int32 thisRadius, Entity *otherEntity, int32 otherRadius)
 {
     int32 x = FROM_FIXED(thisEntity->position.x - otherEntity->position.x);
@@ -13,12 +13,65 @@ int32 RSDK::globalObjectCount = 0;
 int32 RSDK::globalObjectIDs[OBJECT_COUNT];
 int32 RSDK::stageObjectIDs[OBJECT_COUNT];
 
+#if !RETRO_USE_ORIGINAL_CODE
+EntityList RSDK::objectEntityList;
+EntitySchedule RSDK::entitySchedule;
+TempSlotList RSDK::tempSlotList;
+
+// zdepths of a sorted draw list's entities, so sorting doesn't have to keep going back to them
+static int32 drawListDepths[ENTITY_COUNT];
+#else
 EntityBase RSDK::objectEntityList[ENTITY_COUNT];
+#endif
 
 EditableVarInfo *RSDK::editableVarList;
 int32 RSDK::editableVarCount = 0;
 
+#if !RETRO_USE_ORIGINAL_CODE
+HashIndexMD5<OBJECT_COUNT * 2> RSDK::objectClassIndex;
+HashIndexMD5<TYPE_COUNT * 2> RSDK::stageObjectIndex;
+HashIndexMD5<EDITABLEVAR_COUNT * 2> RSDK::editableVarIndex;
+
+static void IndexObjectClass(int32 id)
+{
+    // classes that share a name all get loaded when that name is requested, the index can only hold one of them
+    // so if that ever happens, go back to scanning the list
+    int32 existing = objectClassIndex.Find(objectClassList[id].hash);
+    if (existing >= 0 && existing != id)
+        objectClassIndex.full = true;
+    else
+        objectClassIndex.Add(objectClassList[id].hash, id);
+}
+
+void RSDK::BuildObjectClassIndex()
+{
+    objectClassIndex.Reset();
+    for (int32 o = 0; o < objectClassCount; ++o) IndexObjectClass(o);
+}
+
+int32 RSDK::FindStageObjectID(uint32 *hash)
+{
+    if (!stageObjectIndex.valid) {
+        stageObjectIndex.Reset();
+        for (int32 o = 0; o < sceneInfo.classCount; ++o) stageObjectIndex.Add(objectClassList[stageObjectIDs[o]].hash, o);
+    }
+
+    if (!stageObjectIndex.full)
+        return stageObjectIndex.Find(hash);
+
+    for (int32 o = 0; o < sceneInfo.classCount; ++o) {
+        if (HASH_MATCH_MD5(hash, objectClassList[stageObjectIDs[o]].hash))
+            return o;
+    }
+
+    return -1;
+}
+#endif
+
 TypeGroupList RSDK::typeGroups[TYPEGROUP_COUNT];
+#if !RETRO_USE_ORIGINAL_CODE
+BroadphaseGrid RSDK::broadphaseGrid;
+#endif
 
 bool32 RSDK::validDraw = false;
 
@@ -71,6 +124,10 @@ void RSDK::RegisterObject(Object **staticVars, const char *name, uint32 entityCl
 
         ObjectClass *classInfo = &objectClassList[objectClassCount];
         GEN_HASH_MD5(name, classInfo->hash);
+#if !RETRO_USE_ORIGINAL_CODE
+        if (objectClassIndex.valid)
+            IndexObjectClass(objectClassCount);
+#endif
         classInfo->staticVars      = staticVars;
         classInfo->entityClassSize = entityClassSize;
         classInfo->staticClassSize = staticClassSize;
@@ -88,7 +145,9 @@ void RSDK::RegisterObject(Object **staticVars, const char *name, uint32 entityCl
 #endif
 
 #if !RETRO_USE_ORIGINAL_CODE
-        classInfo->name = name;
+        classInfo->name               = name;
+        classInfo->isolatedUpdate     = NULL;
+        classInfo->isolatedLateUpdate = NULL;
 #endif
 
         ++objectClassCount;
@@ -157,7 +216,11 @@ void RSDK::LoadStaticVariables(uint8 *classPtr, uint32 *hash, int32 readOffset)
                     case SVAR_UINT8:
                     case SVAR_INT8:
                         if (info.readPos + (count * sizeof(uint8)) <= info.fileSize && &classPtr[dataPos]) {
+#if !RETRO_USE_ORIGINAL_CODE
+                            ReadBytes(&info, &classPtr[dataPos], count * sizeof(uint8));
+#else
                             for (int32 i = 0; i < count * sizeof(uint8); i += sizeof(uint8)) ReadBytes(&info, &classPtr[dataPos + i], sizeof(uint8));
+#endif
                         }
                         else {
                             info.readPos += count * sizeof(uint8);
@@ -171,14 +234,14 @@ void RSDK::LoadStaticVariables(uint8 *classPtr, uint32 *hash, int32 readOffset)
                         ALIGN_TO(int16);
 
                         if (info.readPos + (count * sizeof(int16)) <= info.fileSize && &classPtr[dataPos]) {
-                            for (int32 i = 0; i < count * sizeof(int16); i += sizeof(int16)) {
 #if !RETRO_USE_ORIGINAL_CODE
-                                *(int16 *)&classPtr[dataPos + i] = ReadInt16(&info);
+                            ReadArrayInt16(&info, (int16 *)&classPtr[dataPos], count);
 #else
+                            for (int32 i = 0; i < count * sizeof(int16); i += sizeof(int16)) {
                                 // This only works as intended on little-endian CPUs.
                                 ReadBytes(&info, &classPtr[dataPos + i], sizeof(int16));
-#endif
                             }
+#endif
                         }
                         else {
                             info.readPos += count * sizeof(int16);
@@ -193,14 +256,14 @@ void RSDK::LoadStaticVariables(uint8 *classPtr, uint32 *hash, int32 readOffset)
                         ALIGN_TO(int32);
 
                         if (info.readPos + (count * sizeof(int32)) <= info.fileSize && &classPtr[dataPos]) {
-                            for (int32 i = 0; i < count * sizeof(int32); i += sizeof(int32)) {
 #if !RETRO_USE_ORIGINAL_CODE
-                                *(int32 *)&classPtr[dataPos + i] = ReadInt32(&info, false);
+                            ReadArrayInt32(&info, (int32 *)&classPtr[dataPos], count);
 #else
+                            for (int32 i = 0; i < count * sizeof(int32); i += sizeof(int32)) {
                                 // This only works as intended on little-endian CPUs.
                                 ReadBytes(&info, &classPtr[dataPos + i], sizeof(int32));
-#endif
                             }
+#endif
                         }
                         else {
                             info.readPos += count * sizeof(int32);
@@ -214,14 +277,14 @@ void RSDK::LoadStaticVariables(uint8 *classPtr, uint32 *hash, int32 readOffset)
                         ALIGN_TO(bool32);
 
                         if (info.readPos + (count * sizeof(bool32)) <= info.fileSize && &classPtr[dataPos]) {
-                            for (int32 i = 0; i < count * sizeof(bool32); i += sizeof(bool32)) {
 #if !RETRO_USE_ORIGINAL_CODE
-                                *(bool32 *)&classPtr[dataPos + i] = (bool32)ReadInt32(&info, false);
+                            ReadArrayInt32(&info, (int32 *)&classPtr[dataPos], count);
 #else
+                            for (int32 i = 0; i < count * sizeof(bool32); i += sizeof(bool32)) {
                                 // This only works as intended on little-endian CPUs.
                                 ReadBytes(&info, &classPtr[dataPos + i], sizeof(bool32));
-#endif
                             }
+#endif
                         }
                         else {
                             info.readPos += count * sizeof(bool32);
@@ -306,12 +369,435 @@ void RSDK::LoadStaticVariables(uint8 *classPtr, uint32 *hash, int32 readOffset)
     }
 }
 
+#if !RETRO_USE_ORIGINAL_CODE
+void RSDK::UpdateEntityStride()
+{
+    EntityList *list = &objectEntityList;
+
+    // logic mods built against mod loader v3 or older were written when every slot was a full EntityBase
+    // (and may memset/memcpy it as such), so they keep that layout until the loader version is bumped
+    uint32 minSize = sizeof(Entity);
+#if RETRO_USE_MOD_LOADER && RETRO_MOD_LOADER_VER <= 3
+    if (HasActiveLogicMods())
+        minSize = sizeof(EntityBase);
+#endif
+
+    uint32 capacity = minSize;
+    for (int32 i = 0; i < objectClassCount; ++i) capacity = MAX(capacity, (uint32)objectClassList[i].entityClassSize);
+    capacity = MIN((capacity + ENTITY_STRIDE_ALIGN - 1) & ~(ENTITY_STRIDE_ALIGN - 1), (uint32)sizeof(EntityBase));
+
+    if (capacity > list->capacity || !list->slots) {
+        uint8 *slots = (uint8 *)malloc(ENTITY_COUNT * capacity);
+        if (slots) {
+            free(list->slots);
+            list->slots    = slots;
+            list->capacity = capacity;
+        }
+        else if (list->slots) {
+            // the old buffer still works, the stride just gets capped to what it can fit below
+            PrintLog(PRINT_ERROR, "ERROR: Failed to allocate entity list (%d bytes per slot)", capacity);
+        }
+        else {
+            // there's no entity list at all, nothing can run without one
+            PrintLog(PRINT_FATAL, "FATAL: Failed to allocate entity list (%d bytes per slot)", capacity);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // only classes in the stage can be given to entities, so the slots only have to fit them
+    uint32 stride = minSize;
+    for (int32 o = 0; o < sceneInfo.classCount; ++o) stride = MAX(stride, (uint32)objectClassList[stageObjectIDs[o]].entityClassSize);
+    stride = MIN((stride + ENTITY_STRIDE_ALIGN - 1) & ~(ENTITY_STRIDE_ALIGN - 1), (uint32)sizeof(EntityBase));
+
+    if (stride > list->capacity)
+        PrintLog(PRINT_NORMAL, "Entity list can't fit a %d byte class, it only has %d bytes per slot", stride, list->capacity);
+
+    list->stride = MIN(stride, list->capacity);
+    if (list->slots)
+        memset(list->slots, 0, ENTITY_COUNT * list->stride);
+    RefreshTempSlots();
+}
+
+void RSDK::RefreshTempSlots()
+{
+    for (int32 e = TEMPENTITY_START; e < ENTITY_COUNT; ++e) SetTempSlot(e, !objectEntityList.slots || !objectEntityList[e].classID);
+}
+
+static inline int32 GetLowestSetBit(uint32 bits)
+{
+#if defined(__GNUC__)
+    return __builtin_ctz(bits);
+#else
+    int32 id = 0;
+    while (!(bits & 1)) {
+        bits >>= 1;
+        ++id;
+    }
+    return id;
+#endif
+}
+
+// the first temp slot marked free out of the 'count' slots from 'slot' onwards (wrapping around like CreateEntity does), or -1
+static int32 FindFreeTempSlot(int32 slot, int32 count)
+{
+    int32 offset = slot - TEMPENTITY_START;
+    while (count > 0) {
+        int32 span  = MIN(32 - (offset & 0x1F), count);
+        uint32 bits = tempSlotList.free[offset >> 5] >> (offset & 0x1F);
+        if (span < 32)
+            bits &= (1u << span) - 1;
+
+        if (bits)
+            return TEMPENTITY_START + offset + GetLowestSetBit(bits);
+
+        count -= span;
+        offset = (offset + span) % TEMPENTITY_COUNT;
+    }
+
+    return -1;
+}
+
+// entities are handed out to the workers this many at a time
+#define ISOLATED_CHUNK_SIZE (0x20)
+
+// the isolated entities from the pass that's currently running, in slot order
+struct IsolatedBatch {
+    uint16 slots[ENTITY_COUNT];
+    uint16 classIDs[ENTITY_COUNT]; // the class each slot had when it was queued, 0 if it's been skipped
+    int32 count;
+    bool32 late;
+};
+
+static IsolatedBatch isolatedBatch;
+static int32 isolatedWorkerCount = 0; // -1 if the workers couldn't be started
+// these 3 only change while isolatedLock is held
+static int32 isolatedGeneration = 0;
+static int32 isolatedChunkCount = 0;
+static bool32 isolatedClosing   = false;
+static ThreadAtomic isolatedNext; // the next chunk to be taken
+static ThreadAtomic isolatedDone; // entities finished so far
+static ThreadAtomic isolatedBusy; // workers that are still going through the chunks
+#if RETRO_USE_SDL_THREADS
+static SDL_Thread *isolatedWorkers[UPDATE_THREAD_COUNT];
+static SDL_mutex *isolatedLock = NULL;
+static SDL_cond *isolatedWake  = NULL;
+#else
+static std::thread isolatedWorkers[UPDATE_THREAD_COUNT];
+static std::mutex isolatedLock;
+static std::condition_variable isolatedWake;
+#endif
+
+bool32 RSDK::SetIsolatedUpdate(const char *name, void (*update)(void *entity), void (*lateUpdate)(void *entity))
+{
+    RETRO_HASH_MD5(hash);
+    GEN_HASH_MD5(name, hash);
+
+    // every class with that name gets it, same as how they'd all get loaded
+    bool32 found = false;
+    for (int32 o = 0; o < objectClassCount; ++o) {
+        if (HASH_MATCH_MD5(hash, objectClassList[o].hash)) {
+            objectClassList[o].isolatedUpdate     = update;
+            objectClassList[o].isolatedLateUpdate = lateUpdate;
+            found                                 = true;
+        }
+    }
+
+    return found;
+}
+
+static inline void QueueIsolatedEntity(int32 slot)
+{
+    isolatedBatch.slots[isolatedBatch.count]    = slot;
+    isolatedBatch.classIDs[isolatedBatch.count] = objectEntityList[slot].classID;
+    isolatedBatch.count++;
+}
+
+static void RunIsolatedEntity(int32 id)
+{
+    EntityBase *entity = &objectEntityList[isolatedBatch.slots[id]];
+
+    // a regular update later on in the pass could've removed or replaced it
+    if (entity->classID != isolatedBatch.classIDs[id]) {
+        isolatedBatch.classIDs[id] = 0;
+        return;
+    }
+
+    ObjectClass *classInfo = &objectClassList[stageObjectIDs[entity->classID]];
+    if (isolatedBatch.late)
+        classInfo->isolatedLateUpdate(entity);
+    else
+        classInfo->isolatedUpdate(entity);
+}
+
+static void RunIsolatedChunks(int32 chunkCount)
+{
+    while (true) {
+        int32 chunk = AddAtomic(isolatedNext, 1);
+        if (chunk >= chunkCount)
+            break;
+
+        int32 first = chunk * ISOLATED_CHUNK_SIZE;
+        int32 last  = MIN(first + ISOLATED_CHUNK_SIZE, isolatedBatch.count);
+        for (int32 i = first; i < last; ++i) RunIsolatedEntity(i);
+
+        // AtomicAdd is a full barrier, so the entities are written out before the main thread sees them as done
+        AddAtomic(isolatedDone, last - first);
+    }
+}
+
+static int32 IsolatedUpdateWorker(void *data)
+{
+    int32 generation = 0;
+
+    while (true) {
+#if RETRO_USE_SDL_THREADS
+        SDL_LockMutex(isolatedLock);
+        while (generation == isolatedGeneration && !isolatedClosing) SDL_CondWait(isolatedWake, isolatedLock);
+#else
+        std::unique_lock<std::mutex> lock(isolatedLock);
+        while (generation == isolatedGeneration && !isolatedClosing) isolatedWake.wait(lock);
+#endif
+
+        bool32 closing   = isolatedClosing;
+        int32 chunkCount = isolatedChunkCount;
+        generation       = isolatedGeneration;
+        if (!closing)
+            AddAtomic(isolatedBusy, 1);
+
+#if RETRO_USE_SDL_THREADS
+        SDL_UnlockMutex(isolatedLock);
+#else
+        lock.unlock();
+#endif
+
+        if (closing)
+            break;
+
+        RunIsolatedChunks(chunkCount);
+        AddAtomic(isolatedBusy, -1);
+    }
+
+    return 0;
+}
+
+static void StartIsolatedWorkers()
+{
+    isolatedWorkerCount = 0;
+    isolatedClosing     = false;
+
+#if RETRO_USE_SDL_THREADS
+    if (!isolatedLock)
+        isolatedLock = SDL_CreateMutex();
+    if (!isolatedWake)
+        isolatedWake = SDL_CreateCond();
+
+    // the main thread takes part in every batch, so there's no point in more workers than the other cores
+    int32 threadCount = MIN(engine.updateThreads, SDL_GetCPUCount() - 1);
+    if (isolatedLock && isolatedWake) {
+        for (int32 t = 0; t < threadCount; ++t) {
+            isolatedWorkers[t] = SDL_CreateThread((SDL_ThreadFunction)IsolatedUpdateWorker, "IsolatedUpdate", NULL);
+            if (!isolatedWorkers[t])
+                break;
+
+            ++isolatedWorkerCount;
+        }
+    }
+#else
+    // the main thread takes part in every batch, so there's no point in more workers than the other cores
+    // (hardware_concurrency can come back as 0 if it's not known, that's treated as enough cores)
+    int32 threadCount = engine.updateThreads;
+    if (std::thread::hardware_concurrency())
+        threadCount = MIN(threadCount, (int32)std::thread::hardware_concurrency() - 1);
+
+    for (int32 t = 0; t < threadCount; ++t) {
+        isolatedWorkers[t] = std::thread(IsolatedUpdateWorker, (void *)NULL);
+        ++isolatedWorkerCount;
+    }
+#endif
+
+    // no workers means the main thread runs every batch itself
+    if (!isolatedWorkerCount)
+        isolatedWorkerCount = -1;
+}
+
+void RSDK::ReleaseIsolatedUpdates()
+{
+    if (isolatedWorkerCount > 0) {
+#if RETRO_USE_SDL_THREADS
+        SDL_LockMutex(isolatedLock);
+        isolatedClosing = true;
+        SDL_CondBroadcast(isolatedWake);
+        SDL_UnlockMutex(isolatedLock);
+
+        for (int32 t = 0; t < isolatedWorkerCount; ++t) {
+            SDL_WaitThread(isolatedWorkers[t], NULL);
+            isolatedWorkers[t] = NULL;
+        }
+#else
+        {
+            std::lock_guard<std::mutex> lock(isolatedLock);
+            isolatedClosing = true;
+            isolatedWake.notify_all();
+        }
+
+        for (int32 t = 0; t < isolatedWorkerCount; ++t) isolatedWorkers[t].join();
+#endif
+    }
+
+    isolatedWorkerCount = 0;
+}
+
+// runs the batch on the main thread one entity at a time, and reports anything that got written to outside of those entities
+// only the slots outside of the batch can be checked, an isolated update writing to another isolated entity won't be caught
+static void CheckIsolatedBatch()
+{
+    size_t listSize = ENTITY_COUNT * objectEntityList.stride;
+    uint8 *listCopy = (uint8 *)malloc(listSize);
+    uint8 *batched  = (uint8 *)calloc(ENTITY_COUNT, sizeof(uint8));
+    if (!listCopy || !batched) {
+        free(listCopy);
+        free(batched);
+        for (int32 i = 0; i < isolatedBatch.count; ++i) RunIsolatedEntity(i);
+        return;
+    }
+
+    memcpy(listCopy, objectEntityList.slots, listSize);
+    for (int32 i = 0; i < isolatedBatch.count; ++i) batched[isolatedBatch.slots[i]] = true;
+
+    SceneInfo infoCopy = sceneInfo;
+    uint32 seedCopy    = randSeed;
+    for (int32 i = 0; i < isolatedBatch.count; ++i) {
+        const char *name = objectClassList[stageObjectIDs[isolatedBatch.classIDs[i]]].name;
+        RunIsolatedEntity(i);
+
+        if (randSeed != seedCopy) {
+            PrintLog(PRINT_NORMAL, "Isolated %s for %s (slot %d) used the RNG", isolatedBatch.late ? "lateUpdate" : "update", name,
+                     isolatedBatch.slots[i]);
+            seedCopy = randSeed;
+        }
+
+        if (memcmp(&sceneInfo, &infoCopy, sizeof(SceneInfo))) {
+            PrintLog(PRINT_NORMAL, "Isolated %s for %s (slot %d) wrote to sceneInfo", isolatedBatch.late ? "lateUpdate" : "update", name,
+                     isolatedBatch.slots[i]);
+            infoCopy = sceneInfo;
+        }
+    }
+
+    for (int32 e = 0; e < ENTITY_COUNT; ++e) {
+        uint32 offset = e * objectEntityList.stride;
+        if (!batched[e] && memcmp(&objectEntityList.slots[offset], &listCopy[offset], objectEntityList.stride)) {
+            PrintLog(PRINT_NORMAL, "Slot %d (%s) was written to during the isolated %s pass", e,
+                     objectClassList[stageObjectIDs[objectEntityList[e].classID]].name, isolatedBatch.late ? "lateUpdate" : "update");
+        }
+    }
+
+    free(listCopy);
+    free(batched);
+}
+
+// always has the same outcome as running the batch in slot order, since each entity only touches itself
+static void RunIsolatedBatch()
+{
+    IsolatedBatch *batch = &isolatedBatch;
+    if (!batch->count)
+        return;
+
+    BeginProfile(PROFILE_ISOLATED_UPDATE);
+    AddProfileCount(PROFILE_ISOLATED_ENTITIES, batch->count);
+
+    int32 chunkCount = (batch->count + ISOLATED_CHUNK_SIZE - 1) / ISOLATED_CHUNK_SIZE;
+    if (engine.checkIsolated) {
+        CheckIsolatedBatch();
+    }
+    else {
+        if (!isolatedWorkerCount && engine.updateThreads > 0 && chunkCount > 1)
+            StartIsolatedWorkers();
+
+        if (isolatedWorkerCount > 0 && chunkCount > 1) {
+#if RETRO_USE_SDL_THREADS
+            SDL_LockMutex(isolatedLock);
+#else
+            std::unique_lock<std::mutex> lock(isolatedLock);
+#endif
+            // a worker that woke up late for the last batch could still be looking for chunks
+            while (GetAtomic(isolatedBusy)) ThreadYield();
+
+            SetAtomic(isolatedNext, 0);
+            SetAtomic(isolatedDone, 0);
+            isolatedChunkCount = chunkCount;
+            ++isolatedGeneration;
+
+#if RETRO_USE_SDL_THREADS
+            SDL_CondBroadcast(isolatedWake);
+            SDL_UnlockMutex(isolatedLock);
+#else
+            isolatedWake.notify_all();
+            lock.unlock();
+#endif
+
+            // the main thread takes chunks too, so a batch never waits on workers that haven't woken up yet
+            RunIsolatedChunks(chunkCount);
+            while (GetAtomic(isolatedDone) < batch->count) ThreadYield();
+        }
+        else {
+            for (int32 i = 0; i < batch->count; ++i) RunIsolatedEntity(i);
+        }
+    }
+
+    EndProfile(PROFILE_ISOLATED_UPDATE);
+}
+
+// adds the update batch's entities to their draw groups, keeping each group in slot order like the regular pass does
+static void FinishIsolatedUpdates()
+{
+    IsolatedBatch *batch = &isolatedBatch;
+
+    int32 added[DRAWGROUP_COUNT];
+    memset(added, 0, sizeof(added));
+
+    for (int32 i = 0; i < batch->count; ++i) {
+        int32 slot         = batch->slots[i];
+        EntityBase *entity = &objectEntityList[slot];
+
+        if (batch->classIDs[i] && entity->drawGroup < DRAWGROUP_COUNT)
+            added[entity->drawGroup]++;
+
+        entitySchedule.flags[slot] = (entity->inRange ? SCHEDULE_INRANGE : 0) | (entity->onScreen ? SCHEDULE_ONSCREEN : 0);
+        SetTempSlot(slot, !entity->classID);
+    }
+
+    // merge from the back, so the entries already there only move once
+    int32 src[DRAWGROUP_COUNT], dst[DRAWGROUP_COUNT];
+    for (int32 g = 0; g < DRAWGROUP_COUNT; ++g) {
+        src[g] = drawGroups[g].entityCount - 1;
+        dst[g] = drawGroups[g].entityCount + added[g] - 1;
+        drawGroups[g].entityCount += added[g];
+    }
+
+    for (int32 i = batch->count - 1; i >= 0; --i) {
+        int32 slot = batch->slots[i];
+        int32 g    = objectEntityList[slot].drawGroup;
+        if (!batch->classIDs[i] || g >= DRAWGROUP_COUNT)
+            continue;
+
+        uint16 *entries = drawGroups[g].entries;
+        while (src[g] >= 0 && entries[src[g]] > slot) entries[dst[g]--] = entries[src[g]--];
+        entries[dst[g]--] = slot;
+    }
+}
+#endif
+
 void RSDK::InitObjects()
 {
     sceneInfo.entitySlot = 0;
     sceneInfo.createSlot = ENTITY_COUNT - 0x100;
     cameraCount          = 0;
 
+#if !RETRO_USE_ORIGINAL_CODE
+    // the scene's entities are all loaded in by now
+    RefreshTempSlots();
+#endif
+
     for (int32 o = 0; o < sceneInfo.classCount; ++o) {
 #if RETRO_USE_MOD_LOADER
         currentObjectID = o;
@@ -377,6 +863,13 @@ void RSDK::ProcessObjects()
         }
     }
 
+#if !RETRO_USE_ORIGINAL_CODE
+    entitySchedule.valid = true;
+
+    isolatedBatch.count = 0;
+    isolatedBatch.late  = false;
+#endif
+
     sceneInfo.entitySlot = 0;
     for (int32 e = 0; e < ENTITY_COUNT; ++e) {
         sceneInfo.entity = &objectEntityList[e];
@@ -447,7 +940,15 @@ void RSDK::ProcessObjects()
                     break;
             }
 
+#if !RETRO_USE_ORIGINAL_CODE
+            if (sceneInfo.entity->inRange && objectClassList[stageObjectIDs[sceneInfo.entity->classID]].isolatedUpdate) {
+                // isolated classes all get run at once after the pass, they're added to their draw groups then too
+                QueueIsolatedEntity(e);
+            }
+            else if (sceneInfo.entity->inRange) {
+#else
             if (sceneInfo.entity->inRange) {
+#endif
                 if (objectClassList[stageObjectIDs[sceneInfo.entity->classID]].update)
                     objectClassList[stageObjectIDs[sceneInfo.entity->classID]].update();
 
@@ -459,9 +960,21 @@ void RSDK::ProcessObjects()
             sceneInfo.entity->inRange = false;
         }
 
+#if !RETRO_USE_ORIGINAL_CODE
+        // the entity's header was just read anyways, so this is the cheap place to note what the later passes need
+        EntityBase *scheduled   = &objectEntityList[e];
+        entitySchedule.flags[e] = (scheduled->inRange ? SCHEDULE_INRANGE : 0) | (scheduled->onScreen ? SCHEDULE_ONSCREEN : 0);
+        SetTempSlot(e, !scheduled->classID);
+#endif
+
         sceneInfo.entitySlot++;
     }
 
+#if !RETRO_USE_ORIGINAL_CODE
+    RunIsolatedBatch();
+    FinishIsolatedUpdates();
+#endif
+
 #if RETRO_USE_MOD_LOADER
     RunModCallbacks(MODCB_ONUPDATE, INT_TO_VOID(ENGINESTATE_REGULAR));
 #endif
@@ -470,6 +983,12 @@ void RSDK::ProcessObjects()
 
     sceneInfo.entitySlot = 0;
     for (int32 e = 0; e < ENTITY_COUNT; ++e) {
+#if !RETRO_USE_ORIGINAL_CODE
+        if (entitySchedule.valid && !(entitySchedule.flags[e] & SCHEDULE_INRANGE)) {
+            sceneInfo.entitySlot++;
+            continue;
+        }
+#endif
         sceneInfo.entity = &objectEntityList[e];
 
         if (sceneInfo.entity->inRange && sceneInfo.entity->interaction) {
@@ -484,10 +1003,35 @@ void RSDK::ProcessObjects()
         sceneInfo.entitySlot++;
     }
 
+#if !RETRO_USE_ORIGINAL_CODE
+    BuildBroadphaseGrid();
+#endif
+
+#if !RETRO_USE_ORIGINAL_CODE
+    isolatedBatch.count = 0;
+    isolatedBatch.late  = true;
+#endif
+
     sceneInfo.entitySlot = 0;
     for (int32 e = 0; e < ENTITY_COUNT; ++e) {
+#if !RETRO_USE_ORIGINAL_CODE
+        // flags are read as the pass goes, so slots that get copied into by an earlier lateUpdate still get visited
+        if (entitySchedule.valid && !entitySchedule.flags[e]) {
+            sceneInfo.entitySlot++;
+            continue;
+        }
+#endif
         sceneInfo.entity = &objectEntityList[e];
 
+#if !RETRO_USE_ORIGINAL_CODE
+        if (sceneInfo.entity->inRange && objectClassList[stageObjectIDs[sceneInfo.entity->classID]].isolatedLateUpdate) {
+            // its onScreen is cleared once it's been run
+            QueueIsolatedEntity(e);
+            sceneInfo.entitySlot++;
+            continue;
+        }
+#endif
+
         if (sceneInfo.entity->inRange) {
             if (objectClassList[stageObjectIDs[sceneInfo.entity->classID]].lateUpdate)
                 objectClassList[stageObjectIDs[sceneInfo.entity->classID]].lateUpdate();
@@ -496,6 +1040,12 @@ void RSDK::ProcessObjects()
         sceneInfo.entity->onScreen = 0;
         sceneInfo.entitySlot++;
     }
+#if !RETRO_USE_ORIGINAL_CODE
+    RunIsolatedBatch();
+    for (int32 i = 0; i < isolatedBatch.count; ++i) objectEntityList[isolatedBatch.slots[i]].onScreen = 0;
+
+    sceneInfo.entity = &objectEntityList[ENTITY_COUNT - 1];
+#endif
 
 #if RETRO_USE_MOD_LOADER
     RunModCallbacks(MODCB_ONLATEUPDATE, INT_TO_VOID(ENGINESTATE_REGULAR));
@@ -715,6 +1265,10 @@ void RSDK::ProcessFrozenObjects()
         sceneInfo.entitySlot++;
     }
 
+#if !RETRO_USE_ORIGINAL_CODE
+    BuildBroadphaseGrid();
+#endif
+
 #if RETRO_USE_MOD_LOADER
     RunModCallbacks(MODCB_ONLATEUPDATE, INT_TO_VOID(ENGINESTATE_FROZEN));
 #endif
@@ -744,6 +1298,23 @@ void RSDK::ProcessObjectDrawLists()
                         list->hookCB();
 
                     if (list->sorted) {
+#if !RETRO_USE_ORIGINAL_CODE
+                        for (int32 e = 0; e < list->entityCount; ++e) drawListDepths[e] = objectEntityList[list->entries[e]].zdepth;
+
+                        for (int32 e = 0; e < list->entityCount; ++e) {
+                            for (int32 i = list->entityCount - 1; i > e; --i) {
+                                if (drawListDepths[i] > drawListDepths[i - 1]) {
+                                    int32 slot           = list->entries[i - 1];
+                                    list->entries[i - 1] = list->entries[i];
+                                    list->entries[i]     = slot;
+
+                                    int32 depth           = drawListDepths[i - 1];
+                                    drawListDepths[i - 1] = drawListDepths[i];
+                                    drawListDepths[i]     = depth;
+                                }
+                            }
+                        }
+#else
                         for (int32 e = 0; e < list->entityCount; ++e) {
                             for (int32 i = list->entityCount - 1; i > e; --i) {
                                 int32 slot1 = list->entries[i - 1];
@@ -754,6 +1325,7 @@ void RSDK::ProcessObjectDrawLists()
                                 }
                             }
                         }
+#endif
                     }
 
                     for (int32 i = 0; i < list->entityCount; ++i) {
@@ -1008,10 +1580,16 @@ uint16 RSDK::FindObject(const char *name)
     RETRO_HASH_MD5(hash);
     GEN_HASH_MD5(name, hash);
 
+#if !RETRO_USE_ORIGINAL_CODE
+    int32 classID = FindStageObjectID(hash);
+    if (classID >= 0)
+        return classID;
+#else
     for (int32 o = 0; o < sceneInfo.classCount; ++o) {
         if (HASH_MATCH_MD5(hash, objectClassList[stageObjectIDs[o]].hash))
             return o;
     }
+#endif
 
     return TYPE_DEFAULTOBJECT;
 }
@@ -1057,6 +1635,9 @@ void RSDK::ResetEntity(Entity *entity, uint16 classID, void *data)
         }
 
         entity->classID = classID;
+#if !RETRO_USE_ORIGINAL_CODE
+        UpdateTempSlot(entity);
+#endif
     }
 }
 
@@ -1088,6 +1669,10 @@ void RSDK::ResetEntitySlot(uint16 slot, uint16 classID, void *data)
     else {
         entity->classID = classID;
     }
+
+#if !RETRO_USE_ORIGINAL_CODE
+    SetTempSlot(slot, !classID);
+#endif
 }
 
 Entity *RSDK::CreateEntity(uint16 classID, void *data, int32 x, int32 y)
@@ -1095,6 +1680,35 @@ Entity *RSDK::CreateEntity(uint16 classID, void *data, int32 x, int32 y)
     ObjectClass *object = &objectClassList[stageObjectIDs[classID]];
     Entity *entity      = &objectEntityList[sceneInfo.createSlot];
 
+#if !RETRO_USE_ORIGINAL_CODE
+    AddProfileCount(PROFILE_ENTITY_CREATE, 1);
+
+    // the walk below takes the first free slot out of the 17 from createSlot on, so if the bitmap has one there that's the one it'd pick
+    // anything past that (or a createSlot outside of the temp slots) goes through the walk, since that's where live entities get overwritten
+    int32 probeCnt = 0;
+    if (sceneInfo.createSlot >= TEMPENTITY_START && sceneInfo.createSlot < ENTITY_COUNT) {
+        int32 slot = FindFreeTempSlot(sceneInfo.createSlot, 17);
+        while (slot >= 0) {
+            ++probeCnt;
+            if (!objectEntityList[slot].classID)
+                break;
+
+            // something took it without telling the bitmap, look past it
+            SetTempSlot(slot, false);
+            slot = FindFreeTempSlot(sceneInfo.createSlot, 17);
+        }
+
+        if (slot >= 0) {
+            sceneInfo.createSlot = slot;
+            entity               = &objectEntityList[slot];
+        }
+    }
+
+    bool32 walked = entity->classID != 0;
+    if (walked)
+        AddProfileCount(PROFILE_ENTITY_CREATE_WALK, 1);
+#endif
+
     int32 permCnt = 0, loopCnt = 0;
     while (entity->classID) {
         // after 16 loops, the game says fuck it and will start overwriting non-temp objects
@@ -1119,6 +1733,12 @@ Entity *RSDK::CreateEntity(uint16 classID, void *data, int32 x, int32 y)
         ++loopCnt;
     }
 
+#if !RETRO_USE_ORIGINAL_CODE
+    AddProfileCount(PROFILE_ENTITY_CREATE_PROBES, probeCnt + (walked ? loopCnt + 1 : 0));
+    if (entity->classID)
+        AddProfileCount(PROFILE_ENTITY_CREATE_OVERWRITE, 1);
+#endif
+
     memset(entity, 0, object->entityClassSize);
     entity->position.x  = x;
     entity->position.y  = y;
@@ -1146,6 +1766,10 @@ Entity *RSDK::CreateEntity(uint16 classID, void *data, int32 x, int32 y)
         entity->visible = true;
     }
 
+#if !RETRO_USE_ORIGINAL_CODE
+    UpdateTempSlot(entity);
+#endif
+
     return entity;
 }
 
@@ -1177,6 +1801,168 @@ bool32 RSDK::GetActiveEntities(uint16 group, Entity **entity)
 
     return false;
 }
+#if !RETRO_USE_ORIGINAL_CODE
+static inline int32 GetBroadphaseCell(int64 pos, int32 origin, int32 shift, int32 count)
+{
+    int64 cell = (pos - origin) >> shift;
+    return cell < 0 ? 0 : (cell >= count ? count - 1 : (int32)cell);
+}
+
+static inline bool32 CheckEntityInBounds(Entity *entity, uint16 group, int32 left, int32 top, int32 right, int32 bottom)
+{
+    if (group < TYPE_COUNT ? entity->classID != group : entity->group != group)
+        return false;
+
+    // 64 bit so huge ranges (or positions near the edge of the world) can't wrap around
+    int64 rangeX = abs(entity->updateRange.x);
+    int64 rangeY = abs(entity->updateRange.y);
+    return entity->position.x + rangeX >= left && entity->position.x - rangeX <= right && entity->position.y + rangeY >= top
+           && entity->position.y - rangeY <= bottom;
+}
+
+void RSDK::BuildBroadphaseGrid()
+{
+    BroadphaseGrid *grid = &broadphaseGrid;
+
+    // nothing asked for it last frame, so don't bother
+    grid->valid   = grid->queried;
+    grid->queried = false;
+    if (!grid->valid)
+        return;
+
+    BeginProfile(PROFILE_BROADPHASE_BUILD);
+
+    TypeGroupList *list = &typeGroups[GROUP_ALL];
+    memset(grid->maxRange, 0, sizeof(grid->maxRange));
+
+    int32 minX = 0x7FFFFFFF, minY = 0x7FFFFFFF;
+    int32 maxX = -0x7FFFFFFF, maxY = -0x7FFFFFFF;
+    for (int32 i = 0; i < list->entryCount; ++i) {
+        Entity *entity = &objectEntityList[list->entries[i]];
+
+        minX = MIN(minX, entity->position.x);
+        minY = MIN(minY, entity->position.y);
+        maxX = MAX(maxX, entity->position.x);
+        maxY = MAX(maxY, entity->position.y);
+
+        int32 rangeX     = abs(entity->updateRange.x);
+        int32 rangeY     = abs(entity->updateRange.y);
+        uint16 groups[3] = { GROUP_ALL, entity->classID, entity->group };
+        for (int32 g = 0; g < (entity->group >= TYPE_COUNT ? 3 : 2); ++g) {
+            Vector2 *maxRange = &grid->maxRange[groups[g]];
+            maxRange->x       = MAX(maxRange->x, rangeX);
+            maxRange->y       = MAX(maxRange->y, rangeY);
+        }
+    }
+
+    if (!list->entryCount)
+        minX = minY = maxX = maxY = 0;
+
+    grid->cellShift = BROADPHASE_CELL_SHIFT;
+    while ((((int64)maxX - minX) >> grid->cellShift) >= BROADPHASE_GRID_SIZE || (((int64)maxY - minY) >> grid->cellShift) >= BROADPHASE_GRID_SIZE)
+        grid->cellShift++;
+
+    grid->originX = minX;
+    grid->originY = minY;
+    grid->width   = (int32)((((int64)maxX - minX) >> grid->cellShift) + 1);
+    grid->height  = (int32)((((int64)maxY - minY) >> grid->cellShift) + 1);
+
+    // counting sort by cell, filling backwards so each cell keeps its entities in slot order
+    int32 cellCount = grid->width * grid->height;
+    memset(grid->cellStart, 0, (cellCount + 1) * sizeof(uint16));
+    for (int32 i = 0; i < list->entryCount; ++i) {
+        Entity *entity = &objectEntityList[list->entries[i]];
+        int32 cx       = GetBroadphaseCell(entity->position.x, grid->originX, grid->cellShift, grid->width);
+        int32 cy       = GetBroadphaseCell(entity->position.y, grid->originY, grid->cellShift, grid->height);
+        grid->cellStart[cx + cy * grid->width]++;
+    }
+
+    for (int32 c = 1; c <= cellCount; ++c) grid->cellStart[c] += grid->cellStart[c - 1];
+
+    for (int32 i = list->entryCount - 1; i >= 0; --i) {
+        Entity *entity = &objectEntityList[list->entries[i]];
+        int32 cx       = GetBroadphaseCell(entity->position.x, grid->originX, grid->cellShift, grid->width);
+        int32 cy       = GetBroadphaseCell(entity->position.y, grid->originY, grid->cellShift, grid->height);
+        grid->entries[--grid->cellStart[cx + cy * grid->width]] = list->entries[i];
+    }
+
+    EndProfile(PROFILE_BROADPHASE_BUILD);
+}
+
+bool32 RSDK::GetActiveEntitiesInBounds(uint16 group, Entity **entity, int32 left, int32 top, int32 right, int32 bottom)
+{
+    if (group >= TYPEGROUP_COUNT)
+        return false;
+
+    if (!entity)
+        return false;
+
+    BroadphaseGrid *grid = &broadphaseGrid;
+    TypeGroupList *list  = &typeGroups[group];
+
+    if (*entity) {
+        ++foreachStackPtr->id;
+    }
+    else {
+        foreachStackPtr++;
+        foreachStackPtr->id = 0;
+
+        grid->queried = true;
+        AddProfileCount(PROFILE_BOUNDS_QUERY_GROUP, list->entryCount);
+    }
+
+    if (!grid->valid || list->entryCount < BROADPHASE_MIN_ENTRIES) {
+        for (; foreachStackPtr->id < list->entryCount; ++foreachStackPtr->id) {
+            Entity *nextEntity = &objectEntityList[list->entries[foreachStackPtr->id]];
+            if (CheckEntityInBounds(nextEntity, group, left, top, right, bottom)) {
+                AddProfileCount(PROFILE_BOUNDS_QUERY_RESULTS, 1);
+                *entity = nextEntity;
+                return true;
+            }
+        }
+    }
+    else {
+        // positions are from when the grid was built, so pad by a cell for anything that's moved since
+        int64 padX = (int64)grid->maxRange[group].x + ((int64)1 << grid->cellShift);
+        int64 padY = (int64)grid->maxRange[group].y + ((int64)1 << grid->cellShift);
+        int32 x1   = GetBroadphaseCell(left - padX, grid->originX, grid->cellShift, grid->width);
+        int32 x2   = GetBroadphaseCell(right + padX, grid->originX, grid->cellShift, grid->width);
+        int32 y1   = GetBroadphaseCell(top - padY, grid->originY, grid->cellShift, grid->height);
+        int32 y2   = GetBroadphaseCell(bottom + padY, grid->originY, grid->cellShift, grid->height);
+
+        // results have to come out in slot order like GetActiveEntities(), every cell keeps its entities in slot order,
+        // so the next result is the lowest matching slot past the last one across all the cells in range
+        // id holds the lowest slot that can be returned next
+        int32 nextSlot = ENTITY_COUNT;
+        for (int32 row = y1; row <= y2; ++row) {
+            for (int32 cell = x1 + row * grid->width; cell <= x2 + row * grid->width; ++cell) {
+                for (int32 index = grid->cellStart[cell]; index < grid->cellStart[cell + 1]; ++index) {
+                    int32 slot = grid->entries[index];
+                    if (slot >= nextSlot)
+                        break;
+
+                    if (slot >= foreachStackPtr->id && CheckEntityInBounds(&objectEntityList[slot], group, left, top, right, bottom)) {
+                        nextSlot = slot;
+                        break;
+                    }
+                }
+            }
+        }
+
+        if (nextSlot < ENTITY_COUNT) {
+            AddProfileCount(PROFILE_BOUNDS_QUERY_RESULTS, 1);
+            foreachStackPtr->id = nextSlot;
+            *entity             = &objectEntityList[nextSlot];
+            return true;
+        }
+    }
+
+    foreachStackPtr--;
+
+    return false;
+}
+#endif
+
 bool32 RSDK::GetAllEntities(uint16 classID, Entity **entity)
 {
     if (classID >= OBJECT_COUNT)
@@ -182,6 +182,10 @@ struct ObjectClass {
 
 #if !RETRO_USE_ORIGINAL_CODE
     const char *name; // for debugging purposes
+
+    // set through SetIsolatedUpdate(), used in place of update/lateUpdate by ProcessObjects
+    void (*isolatedUpdate)(void *entity);
+    void (*isolatedLateUpdate)(void *entity);
 #endif
 };
 
@@ -211,16 +215,125 @@ extern int32 globalObjectIDs[OBJECT_COUNT];
 // Loaded Stage Objects (includes Globals if "loadGlobals" is enabled)
 extern int32 stageObjectIDs[OBJECT_COUNT];
 
+#if !RETRO_USE_ORIGINAL_CODE
+// entity slots are only as big as the current stage's largest class needs, rather than a full EntityBase each
+// the buffer itself is sized for the largest class that's been registered, so changing stages doesn't reallocate it
+#define ENTITY_STRIDE_ALIGN (0x10)
+
+struct EntityList {
+    uint8 *slots;
+    uint32 stride;
+    uint32 capacity; // bytes available per slot
+
+    inline EntityBase &operator[](int32 slot) { return *(EntityBase *)&slots[slot * stride]; }
+};
+
+extern EntityList objectEntityList;
+
+// call once the stage's classes are known, any entities in the list are lost if the stride changes
+void UpdateEntityStride();
+
+enum EntityScheduleFlags {
+    SCHEDULE_INRANGE  = 1 << 0, // inRange might be set
+    SCHEDULE_ONSCREEN = 1 << 1, // onScreen might be set
+};
+
+// a byte per slot of the engine-owned state ProcessObjects' later passes care about, it's rebuilt by the update pass
+// (which reads every slot anyways) so the typeGroup & lateUpdate passes only have to visit the slots that are flagged
+struct EntitySchedule {
+    uint8 flags[ENTITY_COUNT];
+    bool32 valid;
+};
+
+extern EntitySchedule entitySchedule;
+
+// for anything that writes inRange or onScreen outside of the update pass
+inline void ScheduleEntity(Entity *entity)
+{
+    uint32 offset = (uint32)((uint8 *)entity - objectEntityList.slots);
+    if (offset < ENTITY_COUNT * objectEntityList.stride)
+        entitySchedule.flags[offset / objectEntityList.stride] |= (entity->inRange ? SCHEDULE_INRANGE : 0) | (entity->onScreen ? SCHEDULE_ONSCREEN : 0);
+}
+// anything that rewrites a bunch of slots at once (e.g. restoring a snapshot) should call this, the passes fall back to every slot
+inline void InvalidateEntitySchedule() { entitySchedule.valid = false; }
+
+// a bit per temp slot that's set while its classID is 0, so CreateEntity can find a free slot without walking the list
+// it's only a hint: every slot CreateEntity takes from it is checked first, and the update pass rebuilds it every frame
+// (so slots freed by writing to classID directly get picked back up a frame later)
+struct TempSlotList {
+    uint32 free[TEMPENTITY_COUNT / 32];
+};
+
+extern TempSlotList tempSlotList;
+
+inline void SetTempSlot(int32 slot, bool32 free)
+{
+    slot -= TEMPENTITY_START;
+    if ((uint32)slot < TEMPENTITY_COUNT) {
+        if (free)
+            tempSlotList.free[slot >> 5] |= 1u << (slot & 0x1F);
+        else
+            tempSlotList.free[slot >> 5] &= ~(1u << (slot & 0x1F));
+    }
+}
+// for anything that changes an entity's classID outside of the update pass
+inline void UpdateTempSlot(Entity *entity)
+{
+    uint32 offset = (uint32)((uint8 *)entity - objectEntityList.slots);
+    if (offset < ENTITY_COUNT * objectEntityList.stride)
+        SetTempSlot(offset / objectEntityList.stride, !entity->classID);
+}
+// rebuilds every bit from the list, for when a bunch of slots get rewritten at once
+void RefreshTempSlots();
+#else
 extern EntityBase objectEntityList[ENTITY_COUNT];
+#endif
 
 extern EditableVarInfo *editableVarList;
 extern int32 editableVarCount;
 
+#if !RETRO_USE_ORIGINAL_CODE
+// objectClassList, by name
+extern HashIndexMD5<OBJECT_COUNT * 2> objectClassIndex;
+// stageObjectIDs, by their class' name
+extern HashIndexMD5<TYPE_COUNT * 2> stageObjectIndex;
+// the editable vars registered by the class currently being loaded
+extern HashIndexMD5<EDITABLEVAR_COUNT * 2> editableVarIndex;
+
+void BuildObjectClassIndex();
+int32 FindStageObjectID(uint32 *hash);
+#endif
+
 extern ForeachStackInfo foreachStackList[FOREACH_STACK_COUNT];
 extern ForeachStackInfo *foreachStackPtr;
 
 extern TypeGroupList typeGroups[TYPEGROUP_COUNT];
 
+#if !RETRO_USE_ORIGINAL_CODE
+// Uniform grid of the active entities' positions for GetActiveEntitiesInBounds(), built alongside typeGroups
+// it's only built if something queried it since the last time, otherwise those queries just scan the group
+#define BROADPHASE_GRID_SIZE   (0x40) // max cells per axis
+#define BROADPHASE_CELL_SHIFT  (24)   // smallest cell size (0x100 pixels), cells get bigger if the entities are too spread out
+#define BROADPHASE_MIN_ENTRIES (0x10) // groups smaller than this are scanned either way
+
+struct BroadphaseGrid {
+    int32 originX;
+    int32 originY;
+    int32 width;
+    int32 height;
+    int32 cellShift;
+    bool32 valid;
+    bool32 queried;
+    Vector2 maxRange[TYPEGROUP_COUNT]; // largest updateRange in each group, the query box gets padded by it
+    uint16 cellStart[BROADPHASE_GRID_SIZE * BROADPHASE_GRID_SIZE + 1];
+    uint16 entries[ENTITY_COUNT];
+};
+
+extern BroadphaseGrid broadphaseGrid;
+
+void BuildBroadphaseGrid();
+#endif
+
 extern bool32 validDraw;
 
 #if RETRO_REV0U
@@ -265,6 +378,10 @@ inline void SetEditableVar(uint8 type, const char *name, uint8 classID, int32 of
         EditableVarInfo *var = &editableVarList[editableVarCount];
 
         GEN_HASH_MD5(name, var->hash);
+#if !RETRO_USE_ORIGINAL_CODE
+        if (editableVarIndex.valid)
+            editableVarIndex.Add(var->hash, editableVarCount);
+#endif
         var->type   = type;
         var->offset = offset;
         var->active = true;
@@ -288,10 +405,32 @@ void ProcessPausedObjects();
 void ProcessFrozenObjects();
 void ProcessObjectDrawLists();
 
+#if !RETRO_USE_ORIGINAL_CODE
+#define UPDATE_THREAD_COUNT (8)
+
+// marks a class' update and/or lateUpdate as isolated: it only ever writes to the entity it's given, and only reads that
+// entity plus state that doesn't change during the pass (cameras, static vars, other classes' entities, etc)
+// ProcessObjects runs isolated callbacks across a few worker threads once all of the regular ones in that pass are done,
+// so they have to leave the rest of the engine alone (no creating or destroying entities, sfx, RNG, drawing, etc)
+// an entity can remove itself by setting its classID to TYPE_DEFAULTOBJECT
+// the class' regular callbacks are still used everywhere else (paused & frozen states), passing NULL leaves that callback serial
+bool32 SetIsolatedUpdate(const char *name, void (*update)(void *entity), void (*lateUpdate)(void *entity));
+// stops the isolated update workers, they start back up the next time they're needed
+void ReleaseIsolatedUpdates();
+#endif
+
 uint16 FindObject(const char *name);
 
 inline Entity *GetEntity(uint16 slot) { return &objectEntityList[slot < ENTITY_COUNT ? slot : (ENTITY_COUNT - 1)]; }
+#if !RETRO_USE_ORIGINAL_CODE
+inline int32 GetEntitySlot(EntityBase *entity)
+{
+    uint32 offset = (uint32)((uint8 *)entity - objectEntityList.slots);
+    return offset < ENTITY_COUNT * objectEntityList.stride ? offset / objectEntityList.stride : 0;
+}
+#else
 inline int32 GetEntitySlot(EntityBase *entity) { return (int32)((uint32)(entity - objectEntityList) < ENTITY_COUNT ? entity - objectEntityList : 0); }
+#endif
 int32 GetEntityCount(uint16 classID, bool32 isActive);
 
 void ResetEntity(Entity *entity, uint16 classID, void *data);
@@ -301,15 +440,35 @@ Entity *CreateEntity(uint16 classID, void *data, int32 x, int32 y);
 inline void CopyEntity(void *destEntity, void *srcEntity, bool32 clearSrcEntity)
 {
     if (destEntity && srcEntity) {
+#if !RETRO_USE_ORIGINAL_CODE
+        // either side can be an entity slot, so only a slot's worth is safe to touch
+        // (anything a class uses fits in that, and game-side entity storage is always at least that big)
+        memcpy(destEntity, srcEntity, objectEntityList.stride);
+
+        if (clearSrcEntity)
+            memset(srcEntity, 0, objectEntityList.stride);
+
+        // the copy brings its inRange & onScreen along with it
+        ScheduleEntity((Entity *)destEntity);
+        UpdateTempSlot((Entity *)destEntity);
+        if (clearSrcEntity)
+            UpdateTempSlot((Entity *)srcEntity);
+#else
         memcpy(destEntity, srcEntity, sizeof(EntityBase));
 
         if (clearSrcEntity)
             memset(srcEntity, 0, sizeof(EntityBase));
+#endif
     }
 }
 
 bool32 GetActiveEntities(uint16 group, Entity **entity);
 bool32 GetAllEntities(uint16 classID, Entity **entity);
+#if !RETRO_USE_ORIGINAL_CODE
+// GetActiveEntities(), but only the ones whose update range (position +/- updateRange) overlaps the given box (world space, fixed point)
+// entities are meant to be active whenever any part of them is on screen, so their update range should cover their hitboxes too
+bool32 GetActiveEntitiesInBounds(uint16 group, Entity **entity, int32 left, int32 top, int32 right, int32 bottom);
+#endif
 
 inline void BreakForeachLoop() { --foreachStackPtr; }
 
@@ -20,6 +20,33 @@ char RSDK::currentSceneFolder[0x10];
 char RSDK::currentSceneID[0x10];
 
 SceneInfo RSDK::sceneInfo;
+#if !RETRO_USE_ORIGINAL_CODE
+HashIndexMD5<0x400> RSDK::sceneListIndex;
+#endif
+
+#if !RETRO_USE_ORIGINAL_CODE
+struct StagedLayer {
+    uint16 xsize;
+    uint16 ysize;
+    uint8 *lineScroll;
+    uint16 *layout; // already spread out to the layout's pitch
+};
+
+// PreloadScene()'s output, filled in by the prefetch worker
+// filePath is only ever set on the main thread, and nothing else is touched there until LoadFile() has waited on the worker
+struct StagedScene {
+    char filePath[0x40];
+    bool32 ready;
+    int32 layerCount;
+    StagedLayer layers[LAYER_COUNT];
+    uint64 requestTicks;
+    uint64 stageTicks;
+};
+
+static StagedScene stagedScene;
+// main thread only, a PreloadScene() request that's waiting on the worker to finish its last batch
+static int32 pendingPreload = -1;
+#endif
 
 void RSDK::LoadSceneFolder()
 {
@@ -47,6 +74,12 @@ void RSDK::LoadSceneFolder()
     for (int32 i = 0; i < TYPEGROUP_COUNT; ++i) {
         typeGroups[i].entryCount = 0;
     }
+#if !RETRO_USE_ORIGINAL_CODE
+    broadphaseGrid.valid = false;
+
+    // snapshots from the last scene don't fit this one's state
+    ClearSnapshots();
+#endif
 
 #if RETRO_REV02
     // Unload debug values
@@ -157,11 +190,20 @@ void RSDK::LoadSceneFolder()
 
     // Load TileConfig
     sprintf_s(fullFilePath, sizeof(fullFilePath), "Data/Stages/%s/TileConfig.bin", currentSceneFolder);
+#if !RETRO_USE_ORIGINAL_CODE
+    BeginProfile(PROFILE_LOAD_TILECONFIG);
+#endif
     LoadTileConfig(fullFilePath);
+#if !RETRO_USE_ORIGINAL_CODE
+    EndProfile(PROFILE_LOAD_TILECONFIG);
+#endif
 
     // Load StageConfig
     sprintf_s(fullFilePath, sizeof(fullFilePath), "Data/Stages/%s/StageConfig.bin", currentSceneFolder);
 
+#if !RETRO_USE_ORIGINAL_CODE
+    BeginProfile(PROFILE_LOAD_STAGECONFIG);
+#endif
     FileInfo info;
     InitFileInfo(&info);
     if (LoadFile(&info, fullFilePath, FMODE_RB)) {
@@ -169,6 +211,9 @@ void RSDK::LoadSceneFolder()
 
         if (sig != RSDK_SIGNATURE_CFG) {
             CloseFile(&info);
+#if !RETRO_USE_ORIGINAL_CODE
+            EndProfile(PROFILE_LOAD_STAGECONFIG);
+#endif
             return;
         }
 
@@ -193,6 +238,18 @@ void RSDK::LoadSceneFolder()
             GEN_HASH_MD5(textBuffer, hash);
 
             stageObjectIDs[sceneInfo.classCount] = 0;
+#if !RETRO_USE_ORIGINAL_CODE
+            if (!objectClassIndex.valid)
+                BuildObjectClassIndex();
+
+            if (!objectClassIndex.full) {
+                int32 id = objectClassIndex.Find(hash);
+                if (id >= 0 && id < objectClassCount)
+                    stageObjectIDs[sceneInfo.classCount++] = id;
+                continue;
+            }
+#endif
+
             for (int32 id = 0; id < objectClassCount; ++id) {
                 if (HASH_MATCH_MD5(hash, objectClassList[id].hash)) {
                     stageObjectIDs[sceneInfo.classCount] = id;
@@ -201,6 +258,10 @@ void RSDK::LoadSceneFolder()
             }
         }
 
+#if !RETRO_USE_ORIGINAL_CODE
+        stageObjectIndex.Invalidate();
+#endif
+
         for (int32 o = 0; o < sceneInfo.classCount; ++o) {
             ObjectClass *objClass = &objectClassList[stageObjectIDs[o]];
             if (objClass->staticVars && !*objClass->staticVars) {
@@ -264,9 +325,18 @@ void RSDK::LoadSceneFolder()
 
         CloseFile(&info);
     }
+#if !RETRO_USE_ORIGINAL_CODE
+    EndProfile(PROFILE_LOAD_STAGECONFIG);
+#endif
 
     sprintf_s(fullFilePath, sizeof(fullFilePath), "Data/Stages/%s/16x16Tiles.gif", currentSceneFolder);
+#if !RETRO_USE_ORIGINAL_CODE
+    BeginProfile(PROFILE_LOAD_TILESET);
+#endif
     LoadStageGIF(fullFilePath);
+#if !RETRO_USE_ORIGINAL_CODE
+    EndProfile(PROFILE_LOAD_TILESET);
+#endif
 
 #if RETRO_USE_MOD_LOADER
     for (int32 h = 0; h < (int32)objectHookList.size(); ++h) {
@@ -286,7 +356,12 @@ void RSDK::LoadSceneAssets()
     ShowLoadingIcon();
 #endif
 
+#if !RETRO_USE_ORIGINAL_CODE
+    // the stage's classes are loaded by now, so the slots can be sized for them (this clears them too)
+    UpdateEntityStride();
+#else
     memset(objectEntityList, 0, ENTITY_COUNT * sizeof(EntityBase));
+#endif
 
     SceneListEntry *sceneEntry = &sceneInfo.listData[sceneInfo.listPos];
     char fullFilePath[0x40];
@@ -362,7 +437,18 @@ void RSDK::LoadSceneAssets()
         uint8 strLen = ReadInt8(&info);
         Seek_Cur(&info, strLen + 1);
 
+#if !RETRO_USE_ORIGINAL_CODE
+        // the cooked form has every layer's decompressed lineScroll & layout
+        CookedAsset cooked;
+        bool32 isCooked = LoadCookedAsset(&cooked, &info, COOKED_SCENE);
+
+        bool32 isStaged = stagedScene.ready && strcmp(stagedScene.filePath, fullFilePath) == 0;
+#endif
+
         // Tile Layers
+#if !RETRO_USE_ORIGINAL_CODE
+        ResetCollisionLayerCache();
+#endif
         uint8 layerCount = ReadInt8(&info);
         for (int32 l = 0; l < layerCount; ++l) {
             TileLayer *layer = &tileLayers[l];
@@ -425,6 +511,55 @@ void RSDK::LoadSceneAssets()
                 layer->scrollInfo[s].unknown = ReadInt8(&info);
             }
 
+#if !RETRO_USE_ORIGINAL_CODE
+            if (isCooked) {
+                // skip both compressed blocks
+                Seek_Cur(&info, ReadInt32(&info, false));
+                Seek_Cur(&info, ReadInt32(&info, false));
+
+                ReadCookedBlock(&cooked, layer->lineScroll, TILE_SIZE * size);
+                if (layer->layout)
+                    ReadCookedBlock(&cooked, layer->layout, sizeof(uint16) * (1UL << layer->widthShift) * (1UL << layer->heightShift));
+                continue;
+            }
+
+            StagedLayer *staged = isStaged && l < stagedScene.layerCount ? &stagedScene.layers[l] : NULL;
+            if (staged && staged->xsize == layer->xsize && staged->ysize == layer->ysize) {
+                // PreloadScene() already inflated both blocks, just skip them
+                Seek_Cur(&info, ReadInt32(&info, false));
+                Seek_Cur(&info, ReadInt32(&info, false));
+
+                memcpy(layer->lineScroll, staged->lineScroll, TILE_SIZE * size);
+                if (layer->layout)
+                    memcpy(layer->layout, staged->layout, sizeof(uint16) * (1UL << layer->widthShift) * (1UL << layer->heightShift));
+                AddProfileCount(PROFILE_STAGED_LAYERS, 1);
+                continue;
+            }
+#endif
+
+#if !RETRO_USE_ORIGINAL_CODE
+            ReadCompressedInto(&info, layer->lineScroll, TILE_SIZE * size * sizeof(uint8));
+
+            if (layer->layout) {
+                // the layout's packed as xsize * ysize LE uint16s, inflate that into the start of the layout
+                // then spread the rows out to the layout's pitch, back to front so nothing gets overwritten before it's moved
+                int32 pitch     = 1 << layer->widthShift;
+                uint16 *layout  = layer->layout;
+                int32 tileCount = ReadCompressedInto(&info, layout, sizeof(uint16) * layer->xsize * layer->ysize) / sizeof(uint16);
+                if (CheckBigEndian())
+                    SwapArrayEndian16(layout, tileCount);
+
+                if (pitch != layer->xsize) {
+                    for (int32 y = layer->ysize - 1; y >= 0; --y) {
+                        for (int32 x = layer->xsize - 1; x >= 0; --x) layout[x + y * pitch] = layout[x + y * layer->xsize];
+                        for (int32 x = layer->xsize; x < pitch; ++x) layout[x + y * pitch] = 0xFFFF;
+                    }
+                }
+            }
+            else {
+                ReadCompressedInto(&info, NULL, 0);
+            }
+#else
             uint8 *scrollIndexes = NULL;
             ReadCompressed(&info, (uint8 **)&scrollIndexes);
             memcpy(layer->lineScroll, scrollIndexes, TILE_SIZE * size * sizeof(uint8));
@@ -448,8 +583,40 @@ void RSDK::LoadSceneAssets()
             RemoveStorageEntry((void **)&tileLayout);
 #endif
             tileLayout = NULL;
+#endif
         }
 
+#if !RETRO_USE_ORIGINAL_CODE
+        if (isCooked) {
+            CloseCookedAsset(&cooked);
+        }
+        else {
+            void *blocks[LAYER_COUNT * 2];
+            int32 blockSizes[LAYER_COUNT * 2];
+            int32 blockCount = 0;
+            for (int32 l = 0; l < layerCount; ++l) {
+                TileLayer *layer = &tileLayers[l];
+
+                blocks[blockCount]       = layer->lineScroll;
+                blockSizes[blockCount++] = TILE_SIZE * MAX(layer->xsize, layer->ysize);
+                if (layer->layout) {
+                    blocks[blockCount]       = layer->layout;
+                    blockSizes[blockCount++] = sizeof(uint16) * (1UL << layer->widthShift) * (1UL << layer->heightShift);
+                }
+            }
+
+            SaveCookedAsset(&cooked, blocks, blockSizes, blockCount);
+        }
+
+        if (isStaged) {
+            // measured before the profiler was last reset, so they're added in here
+            AddProfileTicks(PROFILE_SCENE_PRELOAD, stagedScene.requestTicks);
+            AddProfileTicks(PROFILE_SCENE_STAGING, stagedScene.stageTicks);
+            // Scene*.bin is the last file in its batch, so the worker's finished with it
+            ClearStagedScene();
+        }
+#endif
+
         // Objects
         uint8 objectCount = ReadInt8(&info);
         editableVarList   = NULL;
@@ -467,6 +634,9 @@ void RSDK::LoadSceneAssets()
             objHash[2] = ReadInt32(&info, false);
             objHash[3] = ReadInt32(&info, false);
 
+#if !RETRO_USE_ORIGINAL_CODE
+            int32 classID = MAX(FindStageObjectID(objHash), 0);
+#else
             int32 classID = 0;
             for (int32 o = 0; o < sceneInfo.classCount; ++o) {
                 if (HASH_MATCH_MD5(objHash, objectClassList[stageObjectIDs[o]].hash)) {
@@ -474,6 +644,7 @@ void RSDK::LoadSceneAssets()
                     break;
                 }
             }
+#endif
 
 #if !RETRO_USE_ORIGINAL_CODE
             if (!classID && i >= TYPE_DEFAULT_COUNT)
@@ -486,6 +657,9 @@ void RSDK::LoadSceneAssets()
             EditableVarInfo *varList = NULL;
             AllocateStorage((void **)&varList, sizeof(EditableVarInfo) * varCount, DATASET_TMP, false);
             editableVarCount = 0;
+#if !RETRO_USE_ORIGINAL_CODE
+            editableVarIndex.Reset();
+#endif
             if (classID) {
 #if RETRO_REV02
                 SetEditableVar(VAR_UINT8, "filter", classID, offsetof(Entity, filter));
@@ -508,6 +682,15 @@ void RSDK::LoadSceneAssets()
 
                 int32 varID = 0;
                 MEM_ZERO(varList[e]);
+#if !RETRO_USE_ORIGINAL_CODE
+                int32 v = editableVarIndex.Find(varHash);
+                if (v >= 0) {
+                    varID = v;
+                    HASH_COPY_MD5(varList[e].hash, editableVarList[v].hash);
+                    varList[e].offset = editableVarList[v].offset;
+                    varList[e].active = true;
+                }
+#else
                 for (int32 v = 0; v < editableVarCount; ++v) {
                     if (HASH_MATCH_MD5(varHash, editableVarList[v].hash)) {
                         varID = v;
@@ -517,13 +700,53 @@ void RSDK::LoadSceneAssets()
                         break;
                     }
                 }
+#endif
 
                 editableVarList[varID].type = varList[e].type = ReadInt8(&info);
             }
 
             uint16 entityCount = ReadInt16(&info);
+
+            FileInfo *entityInfo = &info;
+#if !RETRO_USE_ORIGINAL_CODE
+            // unless there's a string in there, every entity of a class takes up the same number of bytes
+            // so when reading from disk, pull the whole list in with a single read & parse it from memory
+            FileInfo entityBlock;
+            InitFileInfo(&entityBlock);
+
+            int32 entitySize = sizeof(uint16) + sizeof(Vector2);
+            for (int32 v = 1; v < varCount && entitySize; ++v) {
+                switch (varList[v].type) {
+                    case VAR_UINT8:
+                    case VAR_INT8: entitySize += sizeof(int8); break;
+
+                    case VAR_UINT16:
+                    case VAR_INT16: entitySize += sizeof(int16); break;
+
+                    case VAR_UINT32:
+                    case VAR_INT32:
+                    case VAR_ENUM:
+                    case VAR_BOOL:
+                    case VAR_FLOAT:
+                    case VAR_COLOR: entitySize += sizeof(int32); break;
+
+                    case VAR_VECTOR2: entitySize += sizeof(Vector2); break;
+
+                    default: entitySize = 0; break;
+                }
+            }
+
+            if (!info.usingFileBuffer && entitySize && entityCount > 1) {
+                AllocateStorage((void **)&entityBlock.file, entitySize * entityCount, DATASET_TMP, false);
+
+                entityBlock.fileSize        = (int32)ReadBytes(&info, entityBlock.file, entitySize * entityCount);
+                entityBlock.fileBuffer      = (uint8 *)entityBlock.file;
+                entityBlock.usingFileBuffer = true;
+                entityInfo                  = &entityBlock;
+            }
+#endif
             for (int32 e = 0; e < entityCount; ++e) {
-                uint16 slotID = ReadInt16(&info);
+                uint16 slotID = ReadInt16(entityInfo);
 
                 EntityBase *entity = NULL;
 
@@ -540,8 +763,8 @@ void RSDK::LoadSceneAssets()
 #if RETRO_REV02
                 entity->filter = 0xFF;
 #endif
-                entity->position.x = ReadInt32(&info, false);
-                entity->position.y = ReadInt32(&info, false);
+                entity->position.x = ReadInt32(entityInfo, false);
+                entity->position.y = ReadInt32(entityInfo, false);
 
                 uint8 *entityBuffer = (uint8 *)entity;
 
@@ -551,89 +774,92 @@ void RSDK::LoadSceneAssets()
                         case VAR_UINT8:
                         case VAR_INT8:
                             if (varList[v].active)
-                                ReadBytes(&info, &entityBuffer[varList[v].offset], sizeof(int8));
+                                ReadBytes(entityInfo, &entityBuffer[varList[v].offset], sizeof(int8));
                             else
-                                ReadBytes(&info, tempBuffer, sizeof(int8));
+                                ReadBytes(entityInfo, tempBuffer, sizeof(int8));
                             break;
 
                         case VAR_UINT16:
                         case VAR_INT16:
                             if (varList[v].active)
 #if !RETRO_USE_ORIGINAL_CODE
-                                *(int16 *)&entityBuffer[varList[v].offset] = ReadInt16(&info);
+                                *(int16 *)&entityBuffer[varList[v].offset] = ReadInt16(entityInfo);
 #else
                                 // This only works as intended on little-endian CPUs.
-                                ReadBytes(&info, &entityBuffer[varList[v].offset], sizeof(int16));
+                                ReadBytes(entityInfo, &entityBuffer[varList[v].offset], sizeof(int16));
 #endif
                             else
-                                ReadBytes(&info, tempBuffer, sizeof(int16));
+                                ReadBytes(entityInfo, tempBuffer, sizeof(int16));
                             break;
 
                         case VAR_UINT32:
                         case VAR_INT32:
                             if (varList[v].active)
 #if !RETRO_USE_ORIGINAL_CODE
-                                *(int32 *)&entityBuffer[varList[v].offset] = ReadInt32(&info, false);
+                                *(int32 *)&entityBuffer[varList[v].offset] = ReadInt32(entityInfo, false);
 #else
                                 // This only works as intended on little-endian CPUs.
-                                ReadBytes(&info, &entityBuffer[varList[v].offset], sizeof(int32));
+                                ReadBytes(entityInfo, &entityBuffer[varList[v].offset], sizeof(int32));
 #endif
                             else
-                                ReadBytes(&info, tempBuffer, sizeof(int32));
+                                ReadBytes(entityInfo, tempBuffer, sizeof(int32));
                             break;
 
                         // not entirely sure on specifics here, should always be sizeof(int32) but it having a unique type implies it isn't always
                         case VAR_ENUM:
                             if (varList[v].active)
 #if !RETRO_USE_ORIGINAL_CODE
-                                *(int32 *)&entityBuffer[varList[v].offset] = ReadInt32(&info, false);
+                                *(int32 *)&entityBuffer[varList[v].offset] = ReadInt32(entityInfo, false);
 #else
                                 // This only works as intended on little-endian CPUs.
-                                ReadBytes(&info, &entityBuffer[varList[v].offset], sizeof(int32));
+                                ReadBytes(entityInfo, &entityBuffer[varList[v].offset], sizeof(int32));
 #endif
                             else
-                                ReadBytes(&info, tempBuffer, sizeof(int32));
+                                ReadBytes(entityInfo, tempBuffer, sizeof(int32));
                             break;
 
                         case VAR_BOOL:
                             if (varList[v].active)
 #if !RETRO_USE_ORIGINAL_CODE
-                                *(bool32 *)&entityBuffer[varList[v].offset] = (bool32)ReadInt32(&info, false);
+                                *(bool32 *)&entityBuffer[varList[v].offset] = (bool32)ReadInt32(entityInfo, false);
 #else
                                 // This only works as intended on little-endian CPUs.
-                                ReadBytes(&info, &entityBuffer[varList[v].offset], sizeof(bool32));
+                                ReadBytes(entityInfo, &entityBuffer[varList[v].offset], sizeof(bool32));
 #endif
                             else
-                                ReadBytes(&info, tempBuffer, sizeof(bool32));
+                                ReadBytes(entityInfo, tempBuffer, sizeof(bool32));
                             break;
 
                         case VAR_STRING:
                             if (varList[v].active) {
                                 String *string = (String *)&entityBuffer[varList[v].offset];
-                                uint16 len     = ReadInt16(&info);
+                                uint16 len     = ReadInt16(entityInfo);
 
                                 InitString(string, "", len);
-                                for (string->length = 0; string->length < len; ++string->length) string->chars[string->length] = ReadInt16(&info);
+#if !RETRO_USE_ORIGINAL_CODE
+                                string->length = ReadArrayInt16(entityInfo, (int16 *)string->chars, len);
+#else
+                                for (string->length = 0; string->length < len; ++string->length) string->chars[string->length] = ReadInt16(entityInfo);
+#endif
                             }
                             else {
-                                Seek_Cur(&info, ReadInt16(&info) * sizeof(uint16));
+                                Seek_Cur(entityInfo, ReadInt16(entityInfo) * sizeof(uint16));
                             }
                             break;
 
                         case VAR_VECTOR2:
                             if (varList[v].active) {
 #if !RETRO_USE_ORIGINAL_CODE
-                                *(int32 *)&entityBuffer[varList[v].offset]                 = ReadInt32(&info, false);
-                                *(int32 *)&entityBuffer[varList[v].offset + sizeof(int32)] = ReadInt32(&info, false);
+                                ReadArrayInt32(entityInfo, (int32 *)&entityBuffer[varList[v].offset], 2);
 #else
                                 // This only works as intended on little-endian CPUs.
-                                ReadBytes(&info, &entityBuffer[varList[v].offset], sizeof(int32));
-                                ReadBytes(&info, &entityBuffer[varList[v].offset + sizeof(int32)], sizeof(int32));
+                                ReadBytes(entityInfo, &entityBuffer[varList[v].offset], sizeof(int32));
+                                ReadBytes(entityInfo, &entityBuffer[varList[v].offset + sizeof(int32)], sizeof(int32));
 #endif
                             }
                             else {
-                                ReadBytes(&info, tempBuffer, sizeof(int32)); // x
-                                ReadBytes(&info, tempBuffer, sizeof(int32)); // y
+                                ReadBytes(entityInfo, tempBuffer, sizeof(int32)); // x
+                                ReadBytes(entityInfo, tempBuffer, sizeof(int32)); // y
                             }
                             break;
 
@@ -641,31 +867,34 @@ void RSDK::LoadSceneAssets()
                         case VAR_FLOAT:
                             if (varList[v].active)
 #if !RETRO_USE_ORIGINAL_CODE
-                                *(float *)&entityBuffer[varList[v].offset] = ReadSingle(&info);
+                                *(float *)&entityBuffer[varList[v].offset] = ReadSingle(entityInfo);
 #else
                                 // This only works as intended on little-endian CPUs.
-                                ReadBytes(&info, &entityBuffer[varList[v].offset], sizeof(float));
+                                ReadBytes(entityInfo, &entityBuffer[varList[v].offset], sizeof(float));
 #endif
                             else
-                                ReadBytes(&info, tempBuffer, sizeof(float));
+                                ReadBytes(entityInfo, tempBuffer, sizeof(float));
                             break;
 
                         case VAR_COLOR:
                             if (varList[v].active)
 #if !RETRO_USE_ORIGINAL_CODE
-                                *(color *)&entityBuffer[varList[v].offset] = ReadInt32(&info, false);
+                                *(color *)&entityBuffer[varList[v].offset] = ReadInt32(entityInfo, false);
 #else
                                 // This only works as intended on little-endian CPUs.
-                                ReadBytes(&info, &entityBuffer[varList[v].offset], sizeof(color));
+                                ReadBytes(entityInfo, &entityBuffer[varList[v].offset], sizeof(color));
 #endif
                             else
-                                ReadBytes(&info, tempBuffer, sizeof(color));
+                                ReadBytes(entityInfo, tempBuffer, sizeof(color));
                             break;
                     }
                 }
             }
 
 #if !RETRO_USE_ORIGINAL_CODE
+            if (entityInfo == &entityBlock)
+                RemoveStorageEntry((void **)&entityBlock.file);
+
             RemoveStorageEntry((void **)&varList);
             varList = NULL;
 #endif
@@ -673,6 +902,31 @@ void RSDK::LoadSceneAssets()
 
 #if RETRO_REV02
         // handle filter and stuff
+#if !RETRO_USE_ORIGINAL_CODE
+        int32 activeSlot = RESERVE_ENTITY_COUNT;
+        for (int32 i = RESERVE_ENTITY_COUNT; i < SCENEENTITY_COUNT + RESERVE_ENTITY_COUNT; ++i) {
+            EntityBase *entity = &objectEntityList[i];
+            if (sceneInfo.filter & entity->filter) {
+                if (i != activeSlot) {
+                    memcpy(&objectEntityList[activeSlot], entity, objectEntityList.stride);
+                    memset(entity, 0, objectEntityList.stride);
+                }
+
+                ++activeSlot;
+            }
+            else {
+                memset(entity, 0, objectEntityList.stride);
+            }
+        }
+
+        for (int32 i = 0; i < SCENEENTITY_COUNT; ++i) {
+            if (sceneInfo.filter & tempEntityList[i].filter)
+                memcpy(&objectEntityList[activeSlot++], &tempEntityList[i], objectEntityList.stride);
+
+            if (activeSlot >= SCENEENTITY_COUNT + RESERVE_ENTITY_COUNT)
+                break;
+        }
+#else
         EntityBase *entity = &objectEntityList[RESERVE_ENTITY_COUNT];
         int32 activeSlot   = RESERVE_ENTITY_COUNT;
         for (int32 i = RESERVE_ENTITY_COUNT; i < SCENEENTITY_COUNT + RESERVE_ENTITY_COUNT; ++i) {
@@ -698,6 +952,7 @@ void RSDK::LoadSceneAssets()
             if (activeSlot >= SCENEENTITY_COUNT + RESERVE_ENTITY_COUNT)
                 break;
         }
+#endif
 
 #if !RETRO_USE_ORIGINAL_CODE
         RemoveStorageEntry((void **)&tempEntityList);
@@ -728,6 +983,19 @@ void RSDK::LoadTileConfig(char *filepath)
             return;
         }
 
+#if !RETRO_USE_ORIGINAL_CODE
+        // the cooked form has every plane's masks & info with the flips already worked out
+        CookedAsset cooked;
+        if (LoadCookedAsset(&cooked, &info, COOKED_TILECONFIG)) {
+            ReadCookedBlock(&cooked, collisionMasks, sizeof(collisionMasks));
+            ReadCookedBlock(&cooked, tileInfo, sizeof(tileInfo));
+            CloseCookedAsset(&cooked);
+
+            CloseFile(&info);
+            return;
+        }
+#endif
+
         uint8 *buffer = NULL;
         ReadCompressed(&info, &buffer);
 
@@ -952,6 +1220,10 @@ void RSDK::LoadTileConfig(char *filepath)
 #if !RETRO_USE_ORIGINAL_CODE
         RemoveStorageEntry((void **)&buffer);
         buffer = NULL;
+
+        void *blocks[]     = { collisionMasks, tileInfo };
+        int32 blockSizes[] = { sizeof(collisionMasks), sizeof(tileInfo) };
+        SaveCookedAsset(&cooked, blocks, blockSizes, 2);
 #endif
         CloseFile(&info);
     }
@@ -961,8 +1233,24 @@ void RSDK::LoadStageGIF(char *filepath)
     ImageGIF tileset;
 
     if (tileset.Load(filepath, true) && tileset.width == TILE_SIZE && tileset.height <= TILE_COUNT * TILE_SIZE) {
-        tileset.pixels = tilesetPixels;
-        tileset.Load(NULL, false);
+        bool32 isCooked = false;
+#if !RETRO_USE_ORIGINAL_CODE
+        // the cooked form has the palette & all four planes, flips included
+        CookedAsset cooked;
+        isCooked = LoadCookedAsset(&cooked, &tileset.info, COOKED_TILESET);
+        if (isCooked) {
+            AllocateStorage((void **)&tileset.palette, 0x100 * sizeof(color), DATASET_TMP, true);
+            ReadCookedBlock(&cooked, tileset.palette, 0x100 * sizeof(color));
+            ReadCookedBlock(&cooked, tilesetPixels, sizeof(tilesetPixels));
+            CloseCookedAsset(&cooked);
+            tileset.Close();
+        }
+#endif
+
+        if (!isCooked) {
+            tileset.pixels = tilesetPixels;
+            tileset.Load(NULL, false);
+        }
 
         for (int32 r = 0; r < 0x10; ++r) {
             // only overwrite inactive rows
@@ -976,39 +1264,47 @@ void RSDK::LoadStageGIF(char *filepath)
             }
         }
 
-        // Flip X
-        uint8 *srcPixels = tilesetPixels;
-        uint8 *dstPixels = &tilesetPixels[(FLIP_X * TILESET_SIZE) + (TILE_SIZE - 1)];
-        for (int32 t = 0; t < 0x400 * TILE_SIZE; ++t) {
-            for (int32 r = 0; r < TILE_SIZE; ++r) {
-                *dstPixels-- = *srcPixels++;
+        if (!isCooked) {
+            // Flip X
+            uint8 *srcPixels = tilesetPixels;
+            uint8 *dstPixels = &tilesetPixels[(FLIP_X * TILESET_SIZE) + (TILE_SIZE - 1)];
+            for (int32 t = 0; t < 0x400 * TILE_SIZE; ++t) {
+                for (int32 r = 0; r < TILE_SIZE; ++r) {
+                    *dstPixels-- = *srcPixels++;
+                }
+
+                dstPixels += (TILE_SIZE * 2);
             }
 
-            dstPixels += (TILE_SIZE * 2);
-        }
+            // Flip Y
+            srcPixels = tilesetPixels;
+            for (int32 t = 0; t < 0x400; ++t) {
+                dstPixels = &tilesetPixels[(FLIP_Y * TILESET_SIZE) + (t * TILE_DATASIZE) + (TILE_DATASIZE - TILE_SIZE)];
+                for (int32 y = 0; y < TILE_SIZE; ++y) {
+                    for (int32 x = 0; x < TILE_SIZE; ++x) {
+                        *dstPixels++ = *srcPixels++;
+                    }
 
-        // Flip Y
-        srcPixels = tilesetPixels;
-        for (int32 t = 0; t < 0x400; ++t) {
-            dstPixels = &tilesetPixels[(FLIP_Y * TILESET_SIZE) + (t * TILE_DATASIZE) + (TILE_DATASIZE - TILE_SIZE)];
-            for (int32 y = 0; y < TILE_SIZE; ++y) {
-                for (int32 x = 0; x < TILE_SIZE; ++x) {
-                    *dstPixels++ = *srcPixels++;
+                    dstPixels -= (TILE_SIZE * 2);
                 }
-
-                dstPixels -= (TILE_SIZE * 2);
             }
-        }
 
-        // Flip XY
-        srcPixels = &tilesetPixels[(FLIP_Y * TILESET_SIZE)];
-        dstPixels = &tilesetPixels[(FLIP_XY * TILESET_SIZE) + (TILE_SIZE - 1)];
-        for (int32 t = 0; t < 0x400 * TILE_SIZE; ++t) {
-            for (int32 r = 0; r < TILE_SIZE; ++r) {
-                *dstPixels-- = *srcPixels++;
+            // Flip XY
+            srcPixels = &tilesetPixels[(FLIP_Y * TILESET_SIZE)];
+            dstPixels = &tilesetPixels[(FLIP_XY * TILESET_SIZE) + (TILE_SIZE - 1)];
+            for (int32 t = 0; t < 0x400 * TILE_SIZE; ++t) {
+                for (int32 r = 0; r < TILE_SIZE; ++r) {
+                    *dstPixels-- = *srcPixels++;
+                }
+
+                dstPixels += (TILE_SIZE * 2);
             }
 
-            dstPixels += (TILE_SIZE * 2);
+#if !RETRO_USE_ORIGINAL_CODE
+            void *blocks[]     = { tileset.palette, tilesetPixels };
+            int32 blockSizes[] = { 0x100 * sizeof(color), sizeof(tilesetPixels) };
+            SaveCookedAsset(&cooked, blocks, blockSizes, 2);
+#endif
         }
 
 #if RETRO_USE_ORIGINAL_CODE
@@ -1242,6 +1538,24 @@ void RSDK::SetScene(const char *categoryName, const char *sceneName)
     RETRO_HASH_MD5(scnHash);
     GEN_HASH_MD5(sceneName, scnHash);
 
+#if !RETRO_USE_ORIGINAL_CODE
+    if (!sceneListIndex.valid)
+        BuildSceneListIndex();
+
+    if (!sceneListIndex.full) {
+        int32 category = sceneListIndex.Find(catHash);
+        if (category >= 0 && category < sceneInfo.categoryCount) {
+            sceneInfo.activeCategory = category;
+
+            int32 listPos     = sceneListIndex.Find(scnHash, category + 1);
+            sceneInfo.listPos = listPos >= 0 ? listPos : sceneInfo.listCategory[category].sceneOffsetStart;
+        }
+
+        PrefetchScene();
+        return;
+    }
+#endif
+
     for (int32 i = 0; i < sceneInfo.categoryCount; ++i) {
         if (HASH_MATCH_MD5(sceneInfo.listCategory[i].hash, catHash)) {
             sceneInfo.activeCategory = i;
@@ -1257,8 +1571,787 @@ void RSDK::SetScene(const char *categoryName, const char *sceneName)
             break;
         }
     }
+
+#if !RETRO_USE_ORIGINAL_CODE
+    // games call SetScene() well before LoadScene() (usually before a fade out), so get the disk reads going now
+    PrefetchScene();
+#endif
+}
+
+#if !RETRO_USE_ORIGINAL_CODE
+void RSDK::BuildSceneListIndex()
+{
+    sceneListIndex.Reset();
+
+    // Add() keeps the lowest id for duplicate names, which is the one the list scan would've found first
+    for (int32 c = 0; c < sceneInfo.categoryCount; ++c) {
+        SceneListInfo *category = &sceneInfo.listCategory[c];
+        sceneListIndex.Add(category->hash, c);
+
+        for (int32 s = 0; s < category->sceneCount; ++s) {
+            int32 listPos = category->sceneOffsetStart + s;
+            sceneListIndex.Add(sceneInfo.listData[listPos].hash, listPos, c + 1);
+        }
+    }
 }
 
+static void QueueSceneFiles(int32 listPos, PrefetchCallback onRead)
+{
+    SceneListEntry *sceneEntry = &sceneInfo.listData[listPos];
+
+    char filePaths[4][0x40];
+    const char *fileList[4];
+    int32 fileCount = 0;
+
+    // matches LoadSceneFolder(), the folder's files aren't reloaded if the folder didn't change
+#if RETRO_REV02
+    if (strcmp(currentSceneFolder, sceneEntry->folder) != 0 || forceHardReset) {
+#else
+    if (strcmp(currentSceneFolder, sceneEntry->folder) != 0) {
+#endif
+        sprintf_s(filePaths[fileCount++], sizeof(filePaths[0]), "Data/Stages/%s/TileConfig.bin", sceneEntry->folder);
+        sprintf_s(filePaths[fileCount++], sizeof(filePaths[0]), "Data/Stages/%s/StageConfig.bin", sceneEntry->folder);
+        sprintf_s(filePaths[fileCount++], sizeof(filePaths[0]), "Data/Stages/%s/16x16Tiles.gif", sceneEntry->folder);
+    }
+    sprintf_s(filePaths[fileCount++], sizeof(filePaths[0]), "Data/Stages/%s/Scene%s.bin", sceneEntry->folder, sceneEntry->id);
+
+    for (int32 f = 0; f < fileCount; ++f) fileList[f] = filePaths[f];
+    PrefetchFiles(fileList, fileCount, onRead);
+}
+
+void RSDK::PrefetchScene()
+{
+    if (!sceneInfo.listData || !CheckValidScene())
+        return;
+
+    QueueSceneFiles(sceneInfo.listPos, NULL);
+}
+
+static int32 GetLayerSizeShift(int32 size)
+{
+    // same as LoadSceneAssets()
+    int32 shift  = 1;
+    int32 shift2 = 1;
+    int32 val    = 0;
+    do {
+        shift = shift2;
+        val   = 1 << shift2++;
+    } while (val < size);
+
+    return shift;
+}
+
+// inflates one of a layer's compressed blocks into a new buffer, the block has to fill it exactly
+static bool32 InflateStagedBlock(FileInfo *info, uint8 *buffer, int32 size)
+{
+    int32 cSize = ReadInt32(info, false) - 4;
+    ReadInt32(info, false); // decompressed size, checked against what we actually get
+
+    bool32 success = false;
+    if (cSize >= 0 && cSize <= info->fileSize - info->readPos) {
+        if (size > 0)
+            success = tinfl_decompress_mem_to_mem(buffer, size, info->fileBuffer, cSize, TINFL_FLAG_PARSE_ZLIB_HEADER) == (size_t)size;
+        else
+            success = true;
+
+        Seek_Cur(info, cSize);
+    }
+
+    return success;
+}
+
+static void ReleaseStagedLayers()
+{
+    for (int32 l = 0; l < stagedScene.layerCount; ++l) {
+        free(stagedScene.layers[l].lineScroll);
+        free(stagedScene.layers[l].layout);
+        stagedScene.layers[l].lineScroll = NULL;
+        stagedScene.layers[l].layout     = NULL;
+    }
+
+    stagedScene.layerCount = 0;
+    stagedScene.ready      = false;
+}
+
+// runs on the prefetch worker, walks the scene's layers the same way LoadSceneAssets() does
+static void StageSceneLayers(const char *filePath, uint8 *buffer, int32 size)
+{
+    if (strcmp(filePath, stagedScene.filePath) != 0)
+        return;
+
+    // the batch may have been queued again since this last ran
+    ReleaseStagedLayers();
+
+    uint64 startTicks = GetProfilerTicks();
+
+    FileInfo info;
+    InitFileInfo(&info);
+    info.usingFileBuffer = true;
+    info.file            = (FileIO *)buffer;
+    info.fileBuffer      = buffer;
+    info.fileSize        = size;
+
+    if (ReadInt32(&info, false) != RSDK_SIGNATURE_SCN)
+        return;
+
+    Seek_Cur(&info, 0x10);
+    uint8 strLen = ReadInt8(&info);
+    Seek_Cur(&info, strLen + 1);
+
+    bool32 success   = true;
+    uint8 layerCount = MIN(ReadInt8(&info), LAYER_COUNT);
+    for (int32 l = 0; l < layerCount && success; ++l) {
+        StagedLayer *layer = &stagedScene.layers[l];
+        stagedScene.layerCount = l + 1;
+
+        Seek_Cur(&info, 1); // visibleInEditor
+        Seek_Cur(&info, ReadInt8(&info));
+        Seek_Cur(&info, 2); // type & drawGroup
+
+        layer->xsize = ReadInt16(&info);
+        layer->ysize = ReadInt16(&info);
+        Seek_Cur(&info, 4); // parallaxFactor & scrollSpeed
+        Seek_Cur(&info, ReadInt16(&info) * 6);
+
+        int32 scrollSize  = TILE_SIZE * MAX(layer->xsize, layer->ysize);
+        layer->lineScroll = (uint8 *)calloc(scrollSize ? scrollSize : 1, sizeof(uint8));
+        success           = layer->lineScroll && InflateStagedBlock(&info, layer->lineScroll, scrollSize);
+        if (!success)
+            break;
+
+        if (layer->xsize || layer->ysize) {
+            int32 pitch      = 1 << GetLayerSizeShift(layer->xsize);
+            int32 layoutSize = pitch * (1 << GetLayerSizeShift(layer->ysize));
+            layer->layout    = (uint16 *)malloc(sizeof(uint16) * layoutSize);
+            if (!layer->layout) {
+                success = false;
+                break;
+            }
+
+            memset(layer->layout, 0xFF, sizeof(uint16) * layoutSize);
+            success = InflateStagedBlock(&info, (uint8 *)layer->layout, sizeof(uint16) * layer->xsize * layer->ysize);
+            if (CheckBigEndian())
+                SwapArrayEndian16(layer->layout, layer->xsize * layer->ysize);
+
+            if (pitch != layer->xsize) {
+                uint16 *layout = layer->layout;
+                for (int32 y = layer->ysize - 1; y >= 0; --y) {
+                    for (int32 x = layer->xsize - 1; x >= 0; --x) layout[x + y * pitch] = layout[x + y * layer->xsize];
+                    for (int32 x = layer->xsize; x < pitch; ++x) layout[x + y * pitch] = 0xFFFF;
+                }
+            }
+        }
+        else {
+            success = InflateStagedBlock(&info, NULL, 0);
+        }
+    }
+
+    stagedScene.stageTicks = GetProfilerTicks() - startTicks;
+    // anything that didn't inflate cleanly is left for LoadSceneAssets() to do the usual way
+    stagedScene.ready = success;
+}
+
+bool32 RSDK::PreloadScene(int32 listPos)
+{
+    if (!sceneInfo.listData || sceneInfo.activeCategory >= sceneInfo.categoryCount)
+        return false;
+
+    SceneListInfo *list = &sceneInfo.listCategory[sceneInfo.activeCategory];
+    if (listPos < list->sceneOffsetStart || listPos >= list->sceneOffsetEnd)
+        return false;
+
+    uint64 startTicks = GetProfilerTicks();
+
+    SceneListEntry *sceneEntry = &sceneInfo.listData[listPos];
+    char filePath[0x40];
+    sprintf_s(filePath, sizeof(filePath), "Data/Stages/%s/Scene%s.bin", sceneEntry->folder, sceneEntry->id);
+
+    // a pending request means the current batch was cancelled, so it can't be reused either
+    if (strcmp(stagedScene.filePath, filePath) != 0 || pendingPreload >= 0) {
+        // the worker could still be staging whatever was asked for last, rather than wait on it mid-game
+        // it's told to stop & this gets picked up again by ProcessScenePreload() once it has
+        if (CheckPrefetchBusy()) {
+            CancelPrefetchedFiles();
+            pendingPreload = listPos;
+            return true;
+        }
+
+        // the worker's done, so this doesn't have to wait
+        ClearPrefetchedFiles();
+        ClearStagedScene();
+        sprintf_s(stagedScene.filePath, sizeof(stagedScene.filePath), "%s", filePath);
+    }
+    pendingPreload = -1;
+
+    // no-op if it's already queued
+    QueueSceneFiles(listPos, StageSceneLayers);
+
+    stagedScene.requestTicks += GetProfilerTicks() - startTicks;
+    return true;
+}
+
+void RSDK::ProcessScenePreload()
+{
+    if (pendingPreload >= 0 && !CheckPrefetchBusy()) {
+        int32 listPos  = pendingPreload;
+        pendingPreload = -1;
+        PreloadScene(listPos);
+    }
+}
+
+void RSDK::ClearStagedScene()
+{
+    ReleaseStagedLayers();
+    memset(&stagedScene, 0, sizeof(stagedScene));
+    pendingPreload = -1;
+}
+
+void RSDK::CookSceneAssets()
+{
+    if (!sceneInfo.listData)
+        return;
+
+    for (int32 c = 0; c < sceneInfo.categoryCount; ++c) {
+        SceneListInfo *list = &sceneInfo.listCategory[c];
+
+        for (int32 s = 0; s < list->sceneCount; ++s) {
+            sceneInfo.activeCategory = c;
+            sceneInfo.listPos        = list->sceneOffsetStart + s;
+
+            PrintLog(PRINT_NORMAL, "Cooking \"%s - %s\"", list->name, sceneInfo.listData[sceneInfo.listPos].name);
+            LoadSceneFolder();
+            LoadSceneAssets();
+        }
+    }
+
+    PrintLog(PRINT_NORMAL, "Cooked %d assets", profiler.entries[PROFILE_COOKED_WRITES].count);
+}
+#endif
+
+#if !RETRO_USE_ORIGINAL_CODE
+// a chunk of state the snapshots cover, it gets compared & stored in SNAPSHOT_PAGE_SIZE pages
+struct SnapshotUnit {
+    uint8 *data;
+    uint32 size;   // bytes kept in the reference, all of these get written back when restoring
+    uint32 length; // bytes that can actually change right now, anything past this is skipped when capturing
+    uint32 offset; // where it sits in the reference
+    int32 layerID; // layouts only compare the pages SetTile & CopyTileLayer have marked, -1 for everything else
+};
+
+struct SnapshotEntry {
+    uint32 offset;
+    uint32 size;
+};
+
+// bits of state that don't live in one place, they're gathered in here first so they can be paged like the rest
+struct SnapshotMisc {
+    int32 timeCounter;
+    bool32 timeEnabled;
+    uint8 milliseconds;
+    uint8 seconds;
+    uint8 minutes;
+    uint32 randSeed;
+    int32 cameraCount;
+    CameraInfo cameras[CAMERA_COUNT];
+    Vector2 screenPositions[SCREEN_COUNT];
+};
+
+#define SNAPSHOT_UNIT_COUNT   (ENTITY_COUNT + OBJECT_COUNT + (LAYER_COUNT * 2) + 8)
+#define SNAPSHOT_SCRATCH_SIZE (SNAPSHOT_BUFFER_SIZE / 8)
+#define SNAPSHOT_RECORD_SIZE  (sizeof(uint16) * 3)
+
+struct SnapshotRing {
+    SnapshotUnit units[SNAPSHOT_UNIT_COUNT];
+    int32 unitCount;
+    uint32 signature;
+    uint32 referenceSize;
+    uint32 referenceSignature;
+    // the newest snapshot in full, each entry's delta is what it'd take to turn it back into the one before
+    uint8 *reference;
+    uint32 *dirtyLayout[LAYER_COUNT];
+    uint8 *buffer;
+    uint8 *scratch;
+    uint32 writePos;
+    SnapshotEntry entries[SNAPSHOT_COUNT];
+    int32 first;
+    int32 count;
+    int32 nextID;
+    SnapshotMisc misc;
+};
+
+static SnapshotRing snapshotRing;
+
+static void GatherSnapshotMisc(SnapshotMisc *misc)
+{
+    memset(misc, 0, sizeof(SnapshotMisc));
+
+    misc->timeCounter  = sceneInfo.timeCounter;
+    misc->timeEnabled  = sceneInfo.timeEnabled;
+    misc->milliseconds = sceneInfo.milliseconds;
+    misc->seconds      = sceneInfo.seconds;
+    misc->minutes      = sceneInfo.minutes;
+    misc->randSeed     = randSeed;
+    misc->cameraCount  = cameraCount;
+    memcpy(misc->cameras, cameras, sizeof(cameras));
+    for (int32 s = 0; s < SCREEN_COUNT; ++s) misc->screenPositions[s] = screens[s].position;
+}
+
+static void ScatterSnapshotMisc(SnapshotMisc *misc)
+{
+    sceneInfo.timeCounter  = misc->timeCounter;
+    sceneInfo.timeEnabled  = misc->timeEnabled;
+    sceneInfo.milliseconds = misc->milliseconds;
+    sceneInfo.seconds      = misc->seconds;
+    sceneInfo.minutes      = misc->minutes;
+    randSeed               = misc->randSeed;
+    cameraCount            = misc->cameraCount;
+    memcpy(cameras, misc->cameras, sizeof(cameras));
+    for (int32 s = 0; s < SCREEN_COUNT; ++s) screens[s].position = misc->screenPositions[s];
+}
+
+// only the bytes an entity's class actually uses can change, there's no need to compare the rest of the slot
+static uint32 GetSnapshotEntityLength(Entity *entity)
+{
+    uint32 length = sizeof(Entity);
+    if (entity->classID < sceneInfo.classCount)
+        length = MAX(length, (uint32)objectClassList[stageObjectIDs[entity->classID]].entityClassSize);
+
+    return MIN(length, objectEntityList.stride);
+}
+
+static void AddSnapshotUnit(void *data, uint32 size, uint32 length, int32 layerID)
+{
+    SnapshotRing *ring = &snapshotRing;
+    if (!data || !size || ring->unitCount >= SNAPSHOT_UNIT_COUNT)
+        return;
+
+    SnapshotUnit *unit = &ring->units[ring->unitCount++];
+    unit->data         = (uint8 *)data;
+    unit->size         = size;
+    unit->length       = MIN(length, size);
+    unit->offset       = ring->referenceSize;
+    unit->layerID      = layerID;
+
+    ring->referenceSize += size;
+    ring->signature = (ring->signature * 31) ^ size;
+}
+
+// (re)builds the unit list from the current state, storage can move things around so the pointers are fetched every time
+// returns the layout signature, it only changes if the scene's state is laid out differently (new scene, new classes, etc)
+static uint32 BuildSnapshotUnits()
+{
+    SnapshotRing *ring   = &snapshotRing;
+    ring->unitCount      = 0;
+    ring->signature      = 0;
+    ring->referenceSize  = 0;
+
+    // entities always come first, one unit per slot
+    for (int32 e = 0; e < ENTITY_COUNT; ++e) AddSnapshotUnit(&objectEntityList[e], objectEntityList.stride, GetSnapshotEntityLength(&objectEntityList[e]), -1);
+
+    for (int32 o = 0; o < sceneInfo.classCount; ++o) {
+        ObjectClass *objectClass = &objectClassList[stageObjectIDs[o]];
+        if (objectClass->staticVars)
+            AddSnapshotUnit(*objectClass->staticVars, objectClass->staticClassSize, objectClass->staticClassSize, -1);
+    }
+
+    AddSnapshotUnit(globalVarsPtr, globalVarsSize, globalVarsSize, -1);
+
+    for (int32 l = 0; l < LAYER_COUNT; ++l) {
+        TileLayer *layer = &tileLayers[l];
+        AddSnapshotUnit(layer, offsetof(TileLayer, layout), offsetof(TileLayer, layout), -1);
+
+        if (layer->layout) {
+            uint32 size = sizeof(uint16) << (layer->widthShift + layer->heightShift);
+            AddSnapshotUnit(layer->layout, size, size, l);
+        }
+    }
+
+    AddSnapshotUnit(globalPalette, sizeof(globalPalette), sizeof(globalPalette), -1);
+    AddSnapshotUnit(activeGlobalRows, sizeof(activeGlobalRows), sizeof(activeGlobalRows), -1);
+    AddSnapshotUnit(activeStageRows, sizeof(activeStageRows), sizeof(activeStageRows), -1);
+    AddSnapshotUnit(stagePalette, sizeof(stagePalette), sizeof(stagePalette), -1);
+    AddSnapshotUnit(fullPalette, sizeof(fullPalette), sizeof(fullPalette), -1);
+    AddSnapshotUnit(gfxLineBuffer, sizeof(gfxLineBuffer), sizeof(gfxLineBuffer), -1);
+
+    GatherSnapshotMisc(&ring->misc);
+    AddSnapshotUnit(&ring->misc, sizeof(ring->misc), sizeof(ring->misc), -1);
+
+    return ring->signature;
+}
+
+// packs the XOR of a live & reference page as runs: control bytes below 0x80 are followed by (control + 1) XOR'd bytes,
+// the rest skip over (control - 0x7F) unchanged ones. nothing past 'end' (one past the last changed byte) gets packed
+static uint32 PackSnapshotPage(const uint8 *live, const uint8 *reference, uint32 end, uint8 *dst)
+{
+    uint8 *out = dst;
+    uint32 pos = 0;
+
+    while (pos < end) {
+        uint32 start = pos;
+        if (live[pos] == reference[pos]) {
+            while (pos < end && live[pos] == reference[pos] && pos - start < 0x80) ++pos;
+            *out++ = 0x80 | (pos - start - 1);
+        }
+        else {
+            // lone unchanged bytes are cheaper to keep in the run than to break it up over
+            uint8 *control = out++;
+            while (pos < end && pos - start < 0x80 && (live[pos] != reference[pos] || (pos + 1 < end && live[pos + 1] != reference[pos + 1]))) {
+                *out++ = live[pos] ^ reference[pos];
+                ++pos;
+            }
+            *control = pos - start - 1;
+        }
+    }
+
+    return (uint32)(out - dst);
+}
+
+static void UnpackSnapshotPage(const uint8 *src, uint32 size, uint8 *dst)
+{
+    const uint8 *end = src + size;
+    while (src < end) {
+        uint8 control = *src++;
+        if (control & 0x80) {
+            dst += (control & 0x7F) + 1;
+        }
+        else {
+            for (int32 i = 0; i <= control; ++i) *dst++ ^= *src++;
+        }
+    }
+}
+
+// XORs a delta into the reference, applying an entry's delta to the newest snapshot rolls it back to the one before
+static void ApplySnapshotDelta(const uint8 *delta, uint32 size)
+{
+    SnapshotRing *ring = &snapshotRing;
+    const uint8 *end   = delta + size;
+
+    while (delta < end) {
+        uint16 record[3];
+        memcpy(record, delta, SNAPSHOT_RECORD_SIZE);
+        delta += SNAPSHOT_RECORD_SIZE;
+
+        SnapshotUnit *unit = &ring->units[record[0]];
+        UnpackSnapshotPage(delta, record[2], &ring->reference[unit->offset + record[1] * SNAPSHOT_PAGE_SIZE]);
+        delta += record[2];
+
+        // so RestoreSnapshot knows to check it
+        if (unit->layerID >= 0)
+            ring->dirtyLayout[unit->layerID][record[1] >> 5] |= 1u << (record[1] & 31);
+    }
+}
+
+static void ClearSnapshotLayoutPages()
+{
+    SnapshotRing *ring = &snapshotRing;
+
+    for (int32 l = 0; l < LAYER_COUNT; ++l) {
+        TileLayer *layer = &tileLayers[l];
+        if (ring->dirtyLayout[l] && layer->layout) {
+            uint32 pageCount = ((sizeof(uint16) << (layer->widthShift + layer->heightShift)) + SNAPSHOT_PAGE_SIZE - 1) / SNAPSHOT_PAGE_SIZE;
+            memset(ring->dirtyLayout[l], 0, ((pageCount + 31) / 32) * sizeof(uint32));
+        }
+    }
+}
+
+static void DropOldestSnapshot()
+{
+    SnapshotRing *ring = &snapshotRing;
+
+    ring->first = (ring->first + 1) % SNAPSHOT_COUNT;
+    ring->count--;
+}
+
+// starts the ring over with the current state as its only snapshot
+static int32 StartSnapshotRing()
+{
+    SnapshotRing *ring = &snapshotRing;
+
+    for (int32 u = 0; u < ring->unitCount; ++u) {
+        SnapshotUnit *unit = &ring->units[u];
+        memcpy(&ring->reference[unit->offset], unit->data, unit->size);
+    }
+    ClearSnapshotLayoutPages();
+
+    ring->first    = 0;
+    ring->count    = 1;
+    ring->writePos = 0;
+
+    ring->entries[0].offset = 0;
+    ring->entries[0].size   = 0;
+
+    return ring->nextID++;
+}
+
+static bool32 AllocateSnapshotRing()
+{
+    SnapshotRing *ring = &snapshotRing;
+
+    free(ring->reference);
+    ring->reference = NULL;
+
+    uint32 dirtySize = 0;
+    for (int32 l = 0; l < LAYER_COUNT; ++l) {
+        TileLayer *layer = &tileLayers[l];
+        if (layer->layout) {
+            uint32 pageCount = ((sizeof(uint16) << (layer->widthShift + layer->heightShift)) + SNAPSHOT_PAGE_SIZE - 1) / SNAPSHOT_PAGE_SIZE;
+            dirtySize += ((pageCount + 31) / 32) * sizeof(uint32);
+        }
+    }
+
+    // the reference & the dirty bits go together, the delta buffers stick around until the snapshots are cleared
+    uint8 *reference = (uint8 *)malloc(ring->referenceSize + dirtySize);
+    if (!ring->buffer)
+        ring->buffer = (uint8 *)malloc(SNAPSHOT_BUFFER_SIZE);
+    if (!ring->scratch)
+        ring->scratch = (uint8 *)malloc(SNAPSHOT_SCRATCH_SIZE);
+
+    if (!reference || !ring->buffer || !ring->scratch) {
+        free(reference);
+        ClearSnapshots();
+        return false;
+    }
+
+    ring->reference = reference;
+
+    uint32 *dirty = (uint32 *)&reference[ring->referenceSize];
+    for (int32 l = 0; l < LAYER_COUNT; ++l) {
+        TileLayer *layer     = &tileLayers[l];
+        ring->dirtyLayout[l] = NULL;
+        if (layer->layout) {
+            uint32 pageCount     = ((sizeof(uint16) << (layer->widthShift + layer->heightShift)) + SNAPSHOT_PAGE_SIZE - 1) / SNAPSHOT_PAGE_SIZE;
+            ring->dirtyLayout[l] = dirty;
+            dirty += (pageCount + 31) / 32;
+        }
+    }
+
+    ring->count = 0;
+    return true;
+}
+
+int32 RSDK::CaptureSnapshot()
+{
+    SnapshotRing *ring = &snapshotRing;
+
+    BeginProfile(PROFILE_SNAPSHOT_CAPTURE);
+
+    uint32 signature = BuildSnapshotUnits();
+    if (!ring->reference || !ring->count || signature != ring->referenceSignature) {
+        if (!ring->reference || signature != ring->referenceSignature) {
+            ring->referenceSignature = signature;
+            if (!AllocateSnapshotRing()) {
+                EndProfile(PROFILE_SNAPSHOT_CAPTURE);
+                return -1;
+            }
+        }
+
+        int32 id = StartSnapshotRing();
+        AddProfileCount(PROFILE_SNAPSHOT_BYTES, ring->referenceSize);
+        EndProfile(PROFILE_SNAPSHOT_CAPTURE);
+        return id;
+    }
+
+    uint8 *delta    = ring->scratch;
+    uint8 *deltaEnd = ring->scratch + SNAPSHOT_SCRATCH_SIZE;
+    bool32 overflow = false;
+
+    for (int32 u = 0; u < ring->unitCount; ++u) {
+        SnapshotUnit *unit = &ring->units[u];
+        uint32 *dirty      = unit->layerID >= 0 ? ring->dirtyLayout[unit->layerID] : NULL;
+
+        for (uint32 pos = 0, p = 0; pos < unit->length; pos += SNAPSHOT_PAGE_SIZE, ++p) {
+            if (dirty && !(dirty[p >> 5] & (1u << (p & 31))))
+                continue;
+
+            uint32 size      = MIN(SNAPSHOT_PAGE_SIZE, unit->length - pos);
+            uint8 *live      = &unit->data[pos];
+            uint8 *reference = &ring->reference[unit->offset + pos];
+            if (!memcmp(live, reference, size))
+                continue;
+
+            // worst case every byte ends up in a literal, which costs an extra control byte per 0x80 bytes
+            if (!overflow && (uint32)(deltaEnd - delta) < SNAPSHOT_RECORD_SIZE + size + (size + 0x7F) / 0x80)
+                overflow = true;
+
+            // most changes are near the start of a page (entity positions & such), so the tail can usually be left out
+            while (live[size - 1] == reference[size - 1]) --size;
+
+            if (!overflow) {
+                uint16 record[3];
+                record[0] = u;
+                record[1] = p;
+                record[2] = PackSnapshotPage(live, reference, size, delta + SNAPSHOT_RECORD_SIZE);
+                memcpy(delta, record, SNAPSHOT_RECORD_SIZE);
+                delta += SNAPSHOT_RECORD_SIZE + record[2];
+            }
+
+            memcpy(reference, live, size);
+        }
+    }
+    ClearSnapshotLayoutPages();
+
+    // too much changed to keep a delta for, the ring starts over from here
+    if (overflow) {
+        int32 id = StartSnapshotRing();
+        AddProfileCount(PROFILE_SNAPSHOT_BYTES, ring->referenceSize);
+        EndProfile(PROFILE_SNAPSHOT_CAPTURE);
+        return id;
+    }
+
+    uint32 deltaSize = (uint32)(delta - ring->scratch);
+    if (ring->writePos + deltaSize > SNAPSHOT_BUFFER_SIZE) {
+        // anything past the write position is from the last time around, so it's older than everything before it
+        while (ring->count && ring->entries[ring->first].offset >= ring->writePos) DropOldestSnapshot();
+        ring->writePos = 0;
+    }
+
+    // make room, deltas are laid out in order so the ones in the way are always the oldest
+    while (ring->count) {
+        // the first snapshot has no delta of its own, it only has to go once the one after it does
+        SnapshotEntry *oldest = &ring->entries[ring->first];
+        if (!oldest->size && ring->count > 1)
+            oldest = &ring->entries[(ring->first + 1) % SNAPSHOT_COUNT];
+
+        bool32 overlaps = oldest->offset < ring->writePos + deltaSize && oldest->offset + oldest->size > ring->writePos;
+        if (!overlaps && ring->count < SNAPSHOT_COUNT)
+            break;
+
+        DropOldestSnapshot();
+    }
+
+    SnapshotEntry *entry = &ring->entries[(ring->first + ring->count++) % SNAPSHOT_COUNT];
+    entry->offset        = ring->writePos;
+    entry->size          = deltaSize;
+    memcpy(&ring->buffer[ring->writePos], ring->scratch, deltaSize);
+    ring->writePos += deltaSize;
+
+    AddProfileCount(PROFILE_SNAPSHOT_BYTES, deltaSize);
+    EndProfile(PROFILE_SNAPSHOT_CAPTURE);
+    return ring->nextID++;
+}
+
+bool32 RSDK::RestoreSnapshot(int32 id)
+{
+    SnapshotRing *ring = &snapshotRing;
+
+    int32 oldestID = ring->nextID - ring->count;
+    if (!ring->reference || !ring->count || id < oldestID || id >= ring->nextID)
+        return false;
+
+    // the state isn't laid out like it was when the snapshot was taken, there's nothing to restore it into
+    if (BuildSnapshotUnits() != ring->referenceSignature)
+        return false;
+
+    BeginProfile(PROFILE_SNAPSHOT_RESTORE);
+
+    for (int32 s = ring->count - 1; s > id - oldestID; --s) {
+        SnapshotEntry *entry = &ring->entries[(ring->first + s) % SNAPSHOT_COUNT];
+        ApplySnapshotDelta(&ring->buffer[entry->offset], entry->size);
+    }
+
+    ring->count            = id - oldestID + 1;
+    ring->nextID           = id + 1;
+    SnapshotEntry *newest  = &ring->entries[(ring->first + ring->count - 1) % SNAPSHOT_COUNT];
+    ring->writePos         = newest->offset + newest->size;
+
+    // only pages that differ get written back, so a short rewind doesn't touch much
+    // layout pages can only differ if they were marked since the last capture or one of the deltas changed them
+    for (int32 u = 0; u < ring->unitCount; ++u) {
+        SnapshotUnit *unit = &ring->units[u];
+        uint32 *dirty      = unit->layerID >= 0 ? ring->dirtyLayout[unit->layerID] : NULL;
+
+        // entities only have to go as far as either the live or the restored class uses
+        uint32 length = unit->size;
+        if (u < ENTITY_COUNT)
+            length = MAX(unit->length, GetSnapshotEntityLength((Entity *)&ring->reference[unit->offset]));
+
+        for (uint32 pos = 0, p = 0; pos < length; pos += SNAPSHOT_PAGE_SIZE, ++p) {
+            if (dirty && !(dirty[p >> 5] & (1u << (p & 31))))
+                continue;
+
+            uint32 size      = MIN(SNAPSHOT_PAGE_SIZE, length - pos);
+            uint8 *reference = &ring->reference[unit->offset + pos];
+            if (!memcmp(&unit->data[pos], reference, size))
+                continue;
+
+            memcpy(&unit->data[pos], reference, size);
+
+            if (unit->layerID >= 0) {
+                TileLayer *layer = &tileLayers[unit->layerID];
+                int32 tile       = pos / sizeof(uint16);
+                int32 tileCount  = size / sizeof(uint16);
+                int32 width      = 1 << layer->widthShift;
+
+                if (tileCount >= width)
+                    UpdateCollisionLayerCache(unit->layerID, 0, tile >> layer->widthShift, width, tileCount >> layer->widthShift);
+                else
+                    UpdateCollisionLayerCache(unit->layerID, tile & (width - 1), tile >> layer->widthShift, tileCount, 1);
+            }
+        }
+    }
+    ClearSnapshotLayoutPages();
+
+    ScatterSnapshotMisc(&ring->misc);
+
+    // any slot's inRange, onScreen & classID could've changed
+    InvalidateEntitySchedule();
+    RefreshTempSlots();
+    // and so could everyone's position, bounds queries scan their groups until the grid's rebuilt
+    broadphaseGrid.valid = false;
+
+    EndProfile(PROFILE_SNAPSHOT_RESTORE);
+    return true;
+}
+
+void RSDK::GetSnapshotRange(int32 *oldest, int32 *newest)
+{
+    SnapshotRing *ring = &snapshotRing;
+
+    if (oldest)
+        *oldest = ring->count ? ring->nextID - ring->count : -1;
+    if (newest)
+        *newest = ring->count ? ring->nextID - 1 : -1;
+}
+
+void RSDK::ClearSnapshots()
+{
+    SnapshotRing *ring = &snapshotRing;
+
+    free(ring->reference);
+    free(ring->buffer);
+    free(ring->scratch);
+    ring->reference = NULL;
+    ring->buffer    = NULL;
+    ring->scratch   = NULL;
+    memset(ring->dirtyLayout, 0, sizeof(ring->dirtyLayout));
+
+    ring->first    = 0;
+    ring->count    = 0;
+    ring->nextID   = 0;
+    ring->writePos = 0;
+}
+
+void RSDK::MarkSnapshotLayout(uint16 layerID, int32 tileX, int32 tileY, int32 countX, int32 countY)
+{
+    SnapshotRing *ring = &snapshotRing;
+    if (layerID >= LAYER_COUNT || !ring->dirtyLayout[layerID])
+        return;
+
+    TileLayer *layer = &tileLayers[layerID];
+    int32 left       = MAX(tileX, 0);
+    int32 top        = MAX(tileY, 0);
+    int32 right      = MIN(tileX + countX, (int32)layer->xsize);
+    int32 bottom     = MIN(tileY + countY, (int32)layer->ysize);
+
+    uint32 *dirty = ring->dirtyLayout[layerID];
+    for (int32 y = top; y < bottom; ++y) {
+        uint32 first = ((left + (y << layer->widthShift)) * sizeof(uint16)) / SNAPSHOT_PAGE_SIZE;
+        uint32 last  = (((right - 1) + (y << layer->widthShift)) * sizeof(uint16)) / SNAPSHOT_PAGE_SIZE;
+        for (uint32 p = first; p <= last && left < right; ++p) dirty[p >> 5] |= 1u << (p & 31);
+    }
+}
+#endif
+
 void RSDK::CopyTileLayer(uint16 dstLayerID, int32 dstStartX, int32 dstStartY, uint16 srcLayerID, int32 srcStartX, int32 srcStartY, int32 countX,
                          int32 countY)
 {
@@ -1286,6 +2379,11 @@ void RSDK::CopyTileLayer(uint16 dstLayerID, int32 dstStartX, int32 dstStartY, ui
                         dstLayer->layout[(x + dstStartX) + ((y + dstStartY) << dstLayer->widthShift)] = tile;
                     }
                 }
+
+#if !RETRO_USE_ORIGINAL_CODE
+                UpdateCollisionLayerCache(dstLayerID, dstStartX, dstStartY, countX, countY);
+                MarkSnapshotLayout(dstLayerID, dstStartX, dstStartY, countX, countY);
+#endif
             }
         }
     }
@@ -163,6 +163,14 @@ extern uint8 currentSceneFilter;
 
 extern SceneInfo sceneInfo;
 
+#if !RETRO_USE_ORIGINAL_CODE
+// sceneInfo's categories (group 0) & the scenes in each category (group = category + 1), by name
+// invalidate it whenever the scene list changes, SetScene() rebuilds it on demand
+extern HashIndexMD5<0x400> sceneListIndex;
+
+void BuildSceneListIndex();
+#endif
+
 extern uint8 tilesetPixels[TILESET_SIZE * 4];
 
 void LoadSceneFolder();
@@ -175,6 +183,35 @@ void ProcessParallax(TileLayer *layer);
 void ProcessSceneTimer();
 
 void SetScene(const char *categoryName, const char *sceneName);
+#if !RETRO_USE_ORIGINAL_CODE
+// queues the files LoadSceneFolder() & LoadSceneAssets() will need for sceneInfo.listPos
+void PrefetchScene();
+// queues the files for the scene at listPos (in the active category) while the current scene keeps running
+// the worker also inflates that scene's layer data, so LoadSceneAssets() only has to copy it in
+bool32 PreloadScene(int32 listPos);
+// picks up a PreloadScene() call that came in while the worker was still busy, called once per frame
+void ProcessScenePreload();
+void ClearStagedScene();
+// loads every scene in the scene list so their cooked assets get written
+void CookSceneAssets();
+
+// World Snapshots
+// a ring of snapshots of the scene's mutable state: entities, object statics, globals, tile layers & their layouts, palettes,
+// cameras, the scene timer & the rng. each one only stores the pages that changed since the one before it (XOR'd & run-length packed)
+// audio, sprite/asset data & anything a game allocated for itself aren't covered
+#define SNAPSHOT_COUNT       (0x400)
+#define SNAPSHOT_BUFFER_SIZE (8 * 1024 * 1024) // room for packed deltas, the oldest snapshots get dropped to make more
+#define SNAPSHOT_PAGE_SIZE   (0x400)
+
+// returns the new snapshot's ID (they count up per scene), or -1 if it couldn't be captured
+int32 CaptureSnapshot();
+// rolls the state back to a snapshot in the ring, any newer snapshots are dropped
+// entities are overwritten in place, so call this outside of the entity update loop (e.g. from a staticUpdate)
+bool32 RestoreSnapshot(int32 id);
+// both are -1 if the ring is empty
+void GetSnapshotRange(int32 *oldest, int32 *newest);
+void ClearSnapshots();
+#endif
 inline void LoadScene()
 {
     if ((sceneInfo.state & ENGINESTATE_STEPOVER) == ENGINESTATE_STEPOVER)
@@ -240,12 +277,24 @@ inline uint16 GetTile(uint16 layerID, int32 tileX, int32 tileY)
     return (uint16)-1;
 }
 
+#if !RETRO_USE_ORIGINAL_CODE
+// keeps the collision layer cache (Collision.cpp) in sync with layout changes
+void UpdateCollisionLayerCache(uint16 layerID, int32 tileX, int32 tileY, int32 countX, int32 countY);
+// flags layout pages that've changed since the last snapshot
+void MarkSnapshotLayout(uint16 layerID, int32 tileX, int32 tileY, int32 countX, int32 countY);
+#endif
+
 inline void SetTile(uint16 layerID, int32 tileX, int32 tileY, uint16 tile)
 {
     if (layerID < LAYER_COUNT) {
         TileLayer *layer = &tileLayers[layerID];
-        if (tileX >= 0 && tileX < layer->xsize && tileY >= 0 && tileY < layer->ysize)
+        if (tileX >= 0 && tileX < layer->xsize && tileY >= 0 && tileY < layer->ysize) {
             layer->layout[tileX + (tileY << layer->widthShift)] = tile;
+#if !RETRO_USE_ORIGINAL_CODE
+            UpdateCollisionLayerCache(layerID, tileX, tileY, 1, 1);
+            MarkSnapshotLayout(layerID, tileX, tileY, 1, 1);
+#endif
+        }
     }
 }
 
@@ -119,6 +119,11 @@ void RSDK::AllocateStorage(void **dataPtr, uint32 size, StorageDataSets dataSet,
                 ++storage->entryCount;
             }
             else {
+#if !RETRO_USE_ORIGINAL_CODE
+                if (dataSet == DATASET_TMP)
+                    AddProfileCount(PROFILE_TMP_COLLECTS, 1);
+#endif
+
                 // We've run out of room, so perform defragmentation and garbage-collection.
                 DefragmentAndGarbageCollectStorage(dataSet);
 
@@ -159,6 +164,12 @@ void RSDK::AllocateStorage(void **dataPtr, uint32 size, StorageDataSets dataSet,
             if (storage->entryCount >= STORAGE_ENTRY_COUNT)
                 GarbageCollectStorage(dataSet);
 
+#if !RETRO_USE_ORIGINAL_CODE
+            // how far into the pool TMP allocations have reached, entries that were removed but not collected yet still count
+            if (dataSet == DATASET_TMP && *data)
+                SetProfilePeak(PROFILE_TMP_PEAK, storage->usedStorage * sizeof(uint32));
+#endif
+
             // Clear the allocated memory if requested.
             if (*data != NULL && clear == (bool32)true)
                 memset(*data, 0, size);
@@ -6,6 +6,9 @@ using namespace RSDK;
 #include "Legacy/TextLegacy.cpp"
 #endif
 
+char RSDK::textBuffer[0x400];
+
+#if RETRO_USE_ORIGINAL_CODE
 // From here: https://rosettacode.org/wiki/MD5#C
 
 #include <stdlib.h>
@@ -100,23 +103,14 @@ unsigned *md5(unsigned *h, const char *msg, int32 mlen)
             //            t = u.b[0]; u.b[0] = u.b[3]; u.b[3] = t;
             //            t = u.b[1]; u.b[1] = u.b[2]; u.b[2] = t;
             q -= 8;
-#if !RETRO_USE_ORIGINAL_CODE
-            for (p = 0; p < 4; ++p) msg2[q + p] = (u.w >> (8 * p)) & 0xFF;
-#else
             // This only works as intended on little-endian CPUs.
             memcpy(msg2 + q, &u.w, 4);
-#endif
         }
     }
 
     for (grp = 0; grp < grps; grp++) {
-#if !RETRO_USE_ORIGINAL_CODE
-        memset(&mm, 0, sizeof(mm));
-        for (p = 0; p < 64; ++p) mm.w[p / 4] |= msg2[os + p] << (8 * (p % 4));
-#else
         // This only works as intended on little-endian CPUs.
         memcpy(mm.b, msg2 + os, 64);
-#endif
         for (q = 0; q < 4; q++) abcd[q] = h[q];
         for (p = 0; p < 4; p++) {
             fctn = ff[p];
@@ -143,7 +137,6 @@ unsigned *md5(unsigned *h, const char *msg, int32 mlen)
     return h;
 }
 
-char RSDK::textBuffer[0x400];
 // Buffer is expected to be at least 16 bytes long
 void RSDK::GenerateHashMD5(uint32 *buffer, char *textBuffer, int32 textBufferLen)
 {
@@ -157,6 +150,338 @@ void RSDK::GenerateHashMD5(uint32 *buffer, char *textBuffer, int32 textBufferLen
         for (int32 c = 0; c < 4; ++c) buf[(i << 2) + c] = u.b[c];
     }
 }
+#else
+#if RETRO_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+// MD5 without any allocations or function pointers.
+// The rounds are written once as a template over the word type, so the same code hashes a single string (plain uint32s)
+// or one string per SIMD lane (GenerateHashMD5Multi).
+
+inline uint32 MD5Add(uint32 a, uint32 b) { return a + b; }
+inline uint32 MD5And(uint32 a, uint32 b) { return a & b; }
+inline uint32 MD5Or(uint32 a, uint32 b) { return a | b; }
+inline uint32 MD5Xor(uint32 a, uint32 b) { return a ^ b; }
+inline uint32 MD5Not(uint32 a) { return ~a; }
+template <int32 amt> inline uint32 MD5Rotate(uint32 v) { return (v << amt) | (v >> (32 - amt)); }
+
+template <typename V> inline V MD5Splat(uint32 k);
+template <> inline uint32 MD5Splat<uint32>(uint32 k) { return k; }
+
+#if RETRO_USE_SSE2
+typedef __m128i MD5Vector;
+
+inline __m128i MD5Add(__m128i a, __m128i b) { return _mm_add_epi32(a, b); }
+inline __m128i MD5And(__m128i a, __m128i b) { return _mm_and_si128(a, b); }
+inline __m128i MD5Or(__m128i a, __m128i b) { return _mm_or_si128(a, b); }
+inline __m128i MD5Xor(__m128i a, __m128i b) { return _mm_xor_si128(a, b); }
+inline __m128i MD5Not(__m128i a) { return _mm_xor_si128(a, _mm_set1_epi32(-1)); }
+template <int32 amt> inline __m128i MD5Rotate(__m128i v) { return _mm_or_si128(_mm_slli_epi32(v, amt), _mm_srli_epi32(v, 32 - amt)); }
+template <> inline __m128i MD5Splat<__m128i>(uint32 k) { return _mm_set1_epi32((int32)k); }
+
+inline __m128i MD5Gather(const uint32 *lanes) { return _mm_loadu_si128((const __m128i *)lanes); }
+inline void MD5Scatter(uint32 *lanes, __m128i v) { _mm_storeu_si128((__m128i *)lanes, v); }
+#elif RETRO_USE_ALTIVEC
+typedef __vector unsigned int MD5Vector;
+
+union MD5VectorData {
+    MD5Vector v;
+    uint32 lanes[4];
+};
+
+inline MD5Vector MD5Add(MD5Vector a, MD5Vector b) { return vec_add(a, b); }
+inline MD5Vector MD5And(MD5Vector a, MD5Vector b) { return vec_and(a, b); }
+inline MD5Vector MD5Or(MD5Vector a, MD5Vector b) { return vec_or(a, b); }
+inline MD5Vector MD5Xor(MD5Vector a, MD5Vector b) { return vec_xor(a, b); }
+inline MD5Vector MD5Not(MD5Vector a) { return vec_nor(a, a); }
+// vrlw only looks at the low 5 bits of each shift, which lets every amount fit in vec_splat_s32's -16..15 range
+template <int32 amt> inline MD5Vector MD5Rotate(MD5Vector v) { return vec_rl(v, (MD5Vector)vec_splat_s32(amt >= 16 ? amt - 32 : amt)); }
+template <> inline MD5Vector MD5Splat<MD5Vector>(uint32 k)
+{
+    MD5VectorData data = { { 0 } };
+    data.lanes[0] = data.lanes[1] = data.lanes[2] = data.lanes[3] = k;
+    return data.v;
+}
+
+inline MD5Vector MD5Gather(const uint32 *lanes)
+{
+    MD5VectorData data;
+    memcpy(data.lanes, lanes, sizeof(data.lanes));
+    return data.v;
+}
+inline void MD5Scatter(uint32 *lanes, MD5Vector v)
+{
+    MD5VectorData data;
+    data.v = v;
+    memcpy(lanes, data.lanes, sizeof(data.lanes));
+}
+#endif
+
+template <typename V> inline V MD5F(V x, V y, V z) { return MD5Xor(z, MD5And(x, MD5Xor(y, z))); }
+template <typename V> inline V MD5G(V x, V y, V z) { return MD5Xor(y, MD5And(z, MD5Xor(x, y))); }
+template <typename V> inline V MD5H(V x, V y, V z) { return MD5Xor(MD5Xor(x, y), z); }
+template <typename V> inline V MD5I(V x, V y, V z) { return MD5Xor(y, MD5Or(x, MD5Not(z))); }
+
+#define MD5_STEP(func, a, b, c, d, word, k, s) a = MD5Add(b, MD5Rotate<s>(MD5Add(MD5Add(a, func(b, c, d)), MD5Add(word, MD5Splat<V>(k)))))
+
+template <typename V> void MD5Transform(V *state, const V *w)
+{
+    V a = state[0];
+    V b = state[1];
+    V c = state[2];
+    V d = state[3];
+
+    MD5_STEP(MD5F, a, b, c, d, w[0], 0xD76AA478, 7);
+    MD5_STEP(MD5F, d, a, b, c, w[1], 0xE8C7B756, 12);
+    MD5_STEP(MD5F, c, d, a, b, w[2], 0x242070DB, 17);
+    MD5_STEP(MD5F, b, c, d, a, w[3], 0xC1BDCEEE, 22);
+    MD5_STEP(MD5F, a, b, c, d, w[4], 0xF57C0FAF, 7);
+    MD5_STEP(MD5F, d, a, b, c, w[5], 0x4787C62A, 12);
+    MD5_STEP(MD5F, c, d, a, b, w[6], 0xA8304613, 17);
+    MD5_STEP(MD5F, b, c, d, a, w[7], 0xFD469501, 22);
+    MD5_STEP(MD5F, a, b, c, d, w[8], 0x698098D8, 7);
+    MD5_STEP(MD5F, d, a, b, c, w[9], 0x8B44F7AF, 12);
+    MD5_STEP(MD5F, c, d, a, b, w[10], 0xFFFF5BB1, 17);
+    MD5_STEP(MD5F, b, c, d, a, w[11], 0x895CD7BE, 22);
+    MD5_STEP(MD5F, a, b, c, d, w[12], 0x6B901122, 7);
+    MD5_STEP(MD5F, d, a, b, c, w[13], 0xFD987193, 12);
+    MD5_STEP(MD5F, c, d, a, b, w[14], 0xA679438E, 17);
+    MD5_STEP(MD5F, b, c, d, a, w[15], 0x49B40821, 22);
+
+    MD5_STEP(MD5G, a, b, c, d, w[1], 0xF61E2562, 5);
+    MD5_STEP(MD5G, d, a, b, c, w[6], 0xC040B340, 9);
+    MD5_STEP(MD5G, c, d, a, b, w[11], 0x265E5A51, 14);
+    MD5_STEP(MD5G, b, c, d, a, w[0], 0xE9B6C7AA, 20);
+    MD5_STEP(MD5G, a, b, c, d, w[5], 0xD62F105D, 5);
+    MD5_STEP(MD5G, d, a, b, c, w[10], 0x02441453, 9);
+    MD5_STEP(MD5G, c, d, a, b, w[15], 0xD8A1E681, 14);
+    MD5_STEP(MD5G, b, c, d, a, w[4], 0xE7D3FBC8, 20);
+    MD5_STEP(MD5G, a, b, c, d, w[9], 0x21E1CDE6, 5);
+    MD5_STEP(MD5G, d, a, b, c, w[14], 0xC33707D6, 9);
+    MD5_STEP(MD5G, c, d, a, b, w[3], 0xF4D50D87, 14);
+    MD5_STEP(MD5G, b, c, d, a, w[8], 0x455A14ED, 20);
+    MD5_STEP(MD5G, a, b, c, d, w[13], 0xA9E3E905, 5);
+    MD5_STEP(MD5G, d, a, b, c, w[2], 0xFCEFA3F8, 9);
+    MD5_STEP(MD5G, c, d, a, b, w[7], 0x676F02D9, 14);
+    MD5_STEP(MD5G, b, c, d, a, w[12], 0x8D2A4C8A, 20);
+
+    MD5_STEP(MD5H, a, b, c, d, w[5], 0xFFFA3942, 4);
+    MD5_STEP(MD5H, d, a, b, c, w[8], 0x8771F681, 11);
+    MD5_STEP(MD5H, c, d, a, b, w[11], 0x6D9D6122, 16);
+    MD5_STEP(MD5H, b, c, d, a, w[14], 0xFDE5380C, 23);
+    MD5_STEP(MD5H, a, b, c, d, w[1], 0xA4BEEA44, 4);
+    MD5_STEP(MD5H, d, a, b, c, w[4], 0x4BDECFA9, 11);
+    MD5_STEP(MD5H, c, d, a, b, w[7], 0xF6BB4B60, 16);
+    MD5_STEP(MD5H, b, c, d, a, w[10], 0xBEBFBC70, 23);
+    MD5_STEP(MD5H, a, b, c, d, w[13], 0x289B7EC6, 4);
+    MD5_STEP(MD5H, d, a, b, c, w[0], 0xEAA127FA, 11);
+    MD5_STEP(MD5H, c, d, a, b, w[3], 0xD4EF3085, 16);
+    MD5_STEP(MD5H, b, c, d, a, w[6], 0x04881D05, 23);
+    MD5_STEP(MD5H, a, b, c, d, w[9], 0xD9D4D039, 4);
+    MD5_STEP(MD5H, d, a, b, c, w[12], 0xE6DB99E5, 11);
+    MD5_STEP(MD5H, c, d, a, b, w[15], 0x1FA27CF8, 16);
+    MD5_STEP(MD5H, b, c, d, a, w[2], 0xC4AC5665, 23);
+
+    MD5_STEP(MD5I, a, b, c, d, w[0], 0xF4292244, 6);
+    MD5_STEP(MD5I, d, a, b, c, w[7], 0x432AFF97, 10);
+    MD5_STEP(MD5I, c, d, a, b, w[14], 0xAB9423A7, 15);
+    MD5_STEP(MD5I, b, c, d, a, w[5], 0xFC93A039, 21);
+    MD5_STEP(MD5I, a, b, c, d, w[12], 0x655B59C3, 6);
+    MD5_STEP(MD5I, d, a, b, c, w[3], 0x8F0CCC92, 10);
+    MD5_STEP(MD5I, c, d, a, b, w[10], 0xFFEFF47D, 15);
+    MD5_STEP(MD5I, b, c, d, a, w[1], 0x85845DD1, 21);
+    MD5_STEP(MD5I, a, b, c, d, w[8], 0x6FA87E4F, 6);
+    MD5_STEP(MD5I, d, a, b, c, w[15], 0xFE2CE6E0, 10);
+    MD5_STEP(MD5I, c, d, a, b, w[6], 0xA3014314, 15);
+    MD5_STEP(MD5I, b, c, d, a, w[13], 0x4E0811A1, 21);
+    MD5_STEP(MD5I, a, b, c, d, w[4], 0xF7537E82, 6);
+    MD5_STEP(MD5I, d, a, b, c, w[11], 0xBD3AF235, 10);
+    MD5_STEP(MD5I, c, d, a, b, w[2], 0x2AD7D2BB, 15);
+    MD5_STEP(MD5I, b, c, d, a, w[9], 0xEB86D391, 21);
+
+    state[0] = MD5Add(state[0], a);
+    state[1] = MD5Add(state[1], b);
+    state[2] = MD5Add(state[2], c);
+    state[3] = MD5Add(state[3], d);
+}
+
+#undef MD5_STEP
+
+// MD5 reads the message as little-endian words, assembling them byte by byte keeps this the same on every CPU
+inline void MD5LoadWords(uint32 *words, const uint8 *block)
+{
+    for (int32 i = 0; i < 16; ++i, block += 4) words[i] = block[0] | (block[1] << 8) | (block[2] << 16) | ((uint32)block[3] << 24);
+}
+
+// pads whatever's left of the message (less than 64 bytes) with 0x80, zeroes & the bit length, returns the padded size (64 or 128 bytes)
+inline int32 MD5PadTail(uint8 *tail, const uint8 *text, int32 len, int32 totalLen)
+{
+    int32 tailSize = len < 56 ? 64 : 128;
+    memcpy(tail, text, len);
+    tail[len] = 0x80;
+    memset(&tail[len + 1], 0, tailSize - len - 1);
+
+    uint32 bitsLow  = (uint32)totalLen << 3;
+    uint32 bitsHigh = (uint32)totalLen >> 29;
+    for (int32 i = 0; i < 4; ++i) {
+        tail[tailSize - 8 + i] = (bitsLow >> (8 * i)) & 0xFF;
+        tail[tailSize - 4 + i] = (bitsHigh >> (8 * i)) & 0xFF;
+    }
+
+    return tailSize;
+}
+
+// Buffer is expected to be at least 16 bytes long
+void RSDK::GenerateHashMD5(uint32 *buffer, char *textBuffer, int32 textBufferLen)
+{
+    uint32 state[4] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476 };
+    uint32 words[16];
+
+    const uint8 *text = (const uint8 *)textBuffer;
+    int32 len         = textBufferLen;
+    for (; len >= 64; len -= 64, text += 64) {
+        MD5LoadWords(words, text);
+        MD5Transform(state, words);
+    }
+
+    uint8 tail[128];
+    int32 tailSize = MD5PadTail(tail, text, len, textBufferLen);
+    for (int32 b = 0; b < tailSize; b += 64) {
+        MD5LoadWords(words, &tail[b]);
+        MD5Transform(state, words);
+    }
+
+    memcpy(buffer, state, sizeof(state));
+}
+
+#if RETRO_USE_SSE2 || RETRO_USE_ALTIVEC
+// hashes up to MD5_LANE_COUNT single-block (55 bytes or less) strings at once
+void GenerateHashMD5Lanes(uint32 **hashes, const char **texts, const int32 *lengths, int32 laneCount)
+{
+    // blocks[w][l] = word w of lane l, so each row can be loaded straight into a vector
+    uint32 blocks[16][MD5_LANE_COUNT];
+    memset(blocks, 0, sizeof(blocks));
+
+    for (int32 l = 0; l < laneCount; ++l) {
+        uint8 tail[64];
+        uint32 words[16];
+        MD5PadTail(tail, (const uint8 *)texts[l], lengths[l], lengths[l]);
+        MD5LoadWords(words, tail);
+        for (int32 w = 0; w < 16; ++w) blocks[w][l] = words[w];
+    }
+
+    MD5Vector words[16];
+    for (int32 w = 0; w < 16; ++w) words[w] = MD5Gather(blocks[w]);
+
+    MD5Vector state[4] = { MD5Splat<MD5Vector>(0x67452301), MD5Splat<MD5Vector>(0xEFCDAB89), MD5Splat<MD5Vector>(0x98BADCFE),
+                           MD5Splat<MD5Vector>(0x10325476) };
+    MD5Transform(state, words);
+
+    uint32 results[4][MD5_LANE_COUNT];
+    for (int32 i = 0; i < 4; ++i) MD5Scatter(results[i], state[i]);
+
+    for (int32 l = 0; l < laneCount; ++l) {
+        for (int32 i = 0; i < 4; ++i) hashes[l][i] = results[i][l];
+    }
+}
+
+void RSDK::GenerateHashMD5Multi(uint32 **hashes, const char **texts, int32 count)
+{
+    uint32 *laneHashes[MD5_LANE_COUNT];
+    const char *laneTexts[MD5_LANE_COUNT];
+    int32 laneLengths[MD5_LANE_COUNT];
+    int32 laneCount = 0;
+
+    for (int32 i = 0; i < count; ++i) {
+        int32 len = (int32)strlen(texts[i]);
+
+        // anything longer than a single block isn't worth batching, names almost never are anyway
+        if (len > 55) {
+            GenerateHashMD5(hashes[i], (char *)texts[i], len);
+            continue;
+        }
+
+        laneHashes[laneCount]  = hashes[i];
+        laneTexts[laneCount]   = texts[i];
+        laneLengths[laneCount] = len;
+        if (++laneCount == MD5_LANE_COUNT) {
+            GenerateHashMD5Lanes(laneHashes, laneTexts, laneLengths, laneCount);
+            laneCount = 0;
+        }
+    }
+
+    if (laneCount)
+        GenerateHashMD5Lanes(laneHashes, laneTexts, laneLengths, laneCount);
+}
+#else
+// without SIMD there's nothing to gain from interleaving the strings, so just hash them one by one
+void RSDK::GenerateHashMD5Multi(uint32 **hashes, const char **texts, int32 count)
+{
+    for (int32 i = 0; i < count; ++i) GenerateHashMD5(hashes[i], (char *)texts[i], (int32)strlen(texts[i]));
+}
+#endif
+#endif
+
+#if !RETRO_USE_ORIGINAL_CODE
+#define HASHINTERN_COUNT     (0x800)
+#define HASHINTERN_POOL_SIZE (0x10000)
+
+struct HashInternEntry {
+    uint32 hash[4];
+    uint32 textHash;
+    int32 textOffset; // 0 = empty slot, otherwise (pool offset + 1)
+};
+
+HashInternEntry hashInternList[HASHINTERN_COUNT];
+char hashInternPool[HASHINTERN_POOL_SIZE];
+int32 hashInternCount   = 0;
+int32 hashInternPoolPos = 0;
+
+void RSDK::GenerateHashMD5Interned(uint32 *hash, const char *text)
+{
+    BeginProfile(PROFILE_HASHING);
+
+    // FNV-1a is only used to find the slot, the string itself is compared before a stored MD5 gets used
+    uint32 textHash = 0x811C9DC5;
+    int32 len       = 0;
+    for (; text[len]; ++len) textHash = (textHash ^ (uint8)text[len]) * 0x01000193;
+
+    uint32 slot = textHash & (HASHINTERN_COUNT - 1);
+    for (; hashInternList[slot].textOffset; slot = (slot + 1) & (HASHINTERN_COUNT - 1)) {
+        HashInternEntry *entry = &hashInternList[slot];
+        if (entry->textHash == textHash && strcmp(&hashInternPool[entry->textOffset - 1], text) == 0) {
+            HASH_COPY_MD5(hash, entry->hash);
+
+            AddProfileCount(PROFILE_HASH_INTERN_HITS, 1);
+            EndProfile(PROFILE_HASHING);
+            return;
+        }
+    }
+
+    GenerateHashMD5(hash, (char *)text, len);
+    AddProfileCount(PROFILE_HASH_INTERN_MISSES, 1);
+
+    // out of room, just start over. anything still in use will get added back the next time it's hashed
+    if (hashInternCount >= HASHINTERN_COUNT - (HASHINTERN_COUNT >> 2) || hashInternPoolPos + len + 1 > HASHINTERN_POOL_SIZE) {
+        memset(hashInternList, 0, sizeof(hashInternList));
+        hashInternCount   = 0;
+        hashInternPoolPos = 0;
+        slot              = textHash & (HASHINTERN_COUNT - 1);
+    }
+
+    HashInternEntry *entry = &hashInternList[slot];
+    HASH_COPY_MD5(entry->hash, hash);
+    entry->textHash   = textHash;
+    entry->textOffset = hashInternPoolPos + 1;
+
+    memcpy(&hashInternPool[hashInternPoolPos], text, len + 1);
+    hashInternPoolPos += len + 1;
+    hashInternCount++;
+
+    EndProfile(PROFILE_HASHING);
+}
+#endif
 
 uint32 crc32_t[256] = {
     0x00000000, 0x77073096, 0xee0e612c, 0x990951ba, 0x076dc419, 0x706af48f, 0xe963a535, 0x9e6495a3, 0x0edb8832, 0x79dcb8a4, 0xe0d5e91e, 0x97d2d988,
@@ -138,15 +138,193 @@ void GenerateHashCRC(uint32 *id, char *inputString);
 #define RETRO_HASH_MD5(name) uint32 name[4]
 #define HASH_SIZE_MD5        (4 * sizeof(uint32))
 #define HASH_MATCH_MD5(a, b) (memcmp(a, b, HASH_SIZE_MD5) == 0)
+#if !RETRO_USE_ORIGINAL_CODE
+// how many strings GenerateHashMD5Multi hashes side by side
+#define MD5_LANE_COUNT (4)
+
+// thread-safe, for hashing lists of names in one go (such as the scene list)
+void GenerateHashMD5Multi(uint32 **hashes, const char **texts, int32 count);
+void GenerateHashMD5Interned(uint32 *hash, const char *text);
+
+// this is NOT thread-safe!
+// names get hashed over and over (every GetSfx, FindObject, etc call), so the result is memoized per string
+#define GEN_HASH_MD5(text, hash) GenerateHashMD5Interned(hash, text)
+#else
 // this is NOT thread-safe!
 #define GEN_HASH_MD5(text, hash)                                                                                                                     \
     strcpy(textBuffer, text);                                                                                                                        \
     GenerateHashMD5(hash, textBuffer, (int32)strlen(textBuffer))
+#endif
 // this one is but assumes buffer has already been setup
 #define GEN_HASH_MD5_BUFFER(buffer, hash) GenerateHashMD5(hash, buffer, (int32)strlen(buffer))
 #define HASH_COPY_MD5(dst, src) memcpy(dst, src, HASH_SIZE_MD5)
 #define HASH_CLEAR_MD5(hash)    MEM_ZERO(hash)
 
+#if !RETRO_USE_ORIGINAL_CODE
+struct HashMD5 {
+    uint32 hash[4];
+};
+
+// Compile-time MD5, gives the exact same words as GenerateHashMD5 does at runtime
+// (written as C++11 constexpr, so everything is single-expression recursion)
+namespace ConstMD5
+{
+constexpr uint32 roundConstants[64] = {
+    0xD76AA478, 0xE8C7B756, 0x242070DB, 0xC1BDCEEE, 0xF57C0FAF, 0x4787C62A, 0xA8304613, 0xFD469501, 0x698098D8, 0x8B44F7AF, 0xFFFF5BB1,
+    0x895CD7BE, 0x6B901122, 0xFD987193, 0xA679438E, 0x49B40821, 0xF61E2562, 0xC040B340, 0x265E5A51, 0xE9B6C7AA, 0xD62F105D, 0x02441453,
+    0xD8A1E681, 0xE7D3FBC8, 0x21E1CDE6, 0xC33707D6, 0xF4D50D87, 0x455A14ED, 0xA9E3E905, 0xFCEFA3F8, 0x676F02D9, 0x8D2A4C8A, 0xFFFA3942,
+    0x8771F681, 0x6D9D6122, 0xFDE5380C, 0xA4BEEA44, 0x4BDECFA9, 0xF6BB4B60, 0xBEBFBC70, 0x289B7EC6, 0xEAA127FA, 0xD4EF3085, 0x04881D05,
+    0xD9D4D039, 0xE6DB99E5, 0x1FA27CF8, 0xC4AC5665, 0xF4292244, 0x432AFF97, 0xAB9423A7, 0xFC93A039, 0x655B59C3, 0x8F0CCC92, 0xFFEFF47D,
+    0x85845DD1, 0x6FA87E4F, 0xFE2CE6E0, 0xA3014314, 0x4E0811A1, 0xF7537E82, 0xBD3AF235, 0x2AD7D2BB, 0xEB86D391,
+};
+
+constexpr uint8 rotations[64] = {
+    7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 5, 9,  14, 20, 5, 9,  14, 20, 5, 9,  14, 20, 5, 9,  14, 20,
+    4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21,
+};
+
+constexpr int32 Length(const char *text, int32 pos) { return text[pos] ? Length(text, pos + 1) : pos; }
+constexpr int32 PaddedLength(int32 len) { return 64 * (1 + (len + 8) / 64); }
+
+// the message, then 0x80, then zeroes, with the bit length (low 32 bits only, same as md5()) in the last 8 bytes
+constexpr uint32 Byte(const char *text, int32 len, int32 pos)
+{
+    return pos < len    ? (uint8)text[pos]
+           : pos == len ? 0x80
+           : pos >= PaddedLength(len) - 8 && pos < PaddedLength(len) - 4 ? ((uint32)len * 8 >> (8 * (pos - (PaddedLength(len) - 8)))) & 0xFF
+                                                                         : 0;
+}
+
+constexpr uint32 Word(const char *text, int32 len, int32 pos)
+{
+    return Byte(text, len, pos) | (Byte(text, len, pos + 1) << 8) | (Byte(text, len, pos + 2) << 16) | (Byte(text, len, pos + 3) << 24);
+}
+
+constexpr uint32 Mix(int32 i, uint32 b, uint32 c, uint32 d)
+{
+    return i < 16 ? (b & c) | (~b & d) : i < 32 ? (d & b) | (~d & c) : i < 48 ? b ^ c ^ d : c ^ (b | ~d);
+}
+
+constexpr int32 WordID(int32 i) { return i < 16 ? i : i < 32 ? (5 * i + 1) & 0xF : i < 48 ? (3 * i + 5) & 0xF : (7 * i) & 0xF; }
+
+constexpr uint32 Rotate(uint32 v, int32 amt) { return (v << amt) | (v >> (32 - amt)); }
+
+constexpr HashMD5 Step(const char *text, int32 len, int32 block, int32 i, HashMD5 s)
+{
+    return i == 64 ? s
+                   : Step(text, len, block, i + 1,
+                          HashMD5{ { s.hash[3],
+                                     s.hash[1]
+                                         + Rotate(s.hash[0] + Mix(i, s.hash[1], s.hash[2], s.hash[3]) + roundConstants[i]
+                                                      + Word(text, len, (block * 64) + (WordID(i) * 4)),
+                                                  rotations[i]),
+                                     s.hash[1], s.hash[2] } });
+}
+
+constexpr HashMD5 Sum(HashMD5 a, HashMD5 b)
+{
+    return HashMD5{ { a.hash[0] + b.hash[0], a.hash[1] + b.hash[1], a.hash[2] + b.hash[2], a.hash[3] + b.hash[3] } };
+}
+
+constexpr HashMD5 Blocks(const char *text, int32 len, int32 block, HashMD5 s)
+{
+    return block * 64 == PaddedLength(len) ? s : Blocks(text, len, block + 1, Sum(s, Step(text, len, block, 0, s)));
+}
+} // namespace ConstMD5
+
+constexpr HashMD5 ConstHashMD5(const char *text)
+{
+    return ConstMD5::Blocks(text, ConstMD5::Length(text, 0), 0, HashMD5{ { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476 } });
+}
+static_assert(ConstHashMD5("").hash[0] == 0xD98C1DD4 && ConstHashMD5("").hash[3] == 0x7E42F8EC, "ConstHashMD5 doesn't match MD5");
+
+// for string literals, the hash is baked in at compile time
+#define GEN_HASH_MD5_CONST(text, buffer)                                                                                                             \
+    do {                                                                                                                                             \
+        constexpr RSDK::HashMD5 constHash = RSDK::ConstHashMD5(text);                                                                                \
+        HASH_COPY_MD5(buffer, constHash.hash);                                                                                                       \
+    } while (0)
+
+// Open-addressed hash -> ID index for the engine's name tables (sfx, sprites, objects, data files, etc)
+// Lookups that used to scan the whole table with HASH_MATCH_MD5 go through this instead.
+// Duplicates resolve to the lowest ID, same as the old scans did, and 'group' lets one index cover
+// a 2D table (such as the animations of every sprite sheet).
+// Tables call Invalidate() whenever an entry gets removed or overwritten and rebuild on their next lookup,
+// 'full' is set if the table ever outgrew the index, in which case the old scan has to be used instead.
+template <int32 size> struct HashIndexMD5 {
+    struct Entry {
+        uint32 hash[4];
+        uint32 group;
+        int32 id;
+        uint32 generation;
+    };
+
+    Entry entries[size];
+    uint32 generation;
+    int32 count;
+    bool32 valid;
+    bool32 full;
+
+    inline void Reset()
+    {
+        // bumping the generation empties every entry without having to touch them
+        if (!++generation) {
+            memset(entries, 0, sizeof(entries));
+            generation = 1;
+        }
+
+        count = 0;
+        valid = true;
+        full  = false;
+    }
+
+    inline void Invalidate() { valid = false; }
+
+    inline int32 Find(const uint32 *hash, uint32 group = 0) const
+    {
+        for (uint32 slot = GetSlot(hash, group); entries[slot].generation == generation; slot = (slot + 1) & (size - 1)) {
+            if (entries[slot].group == group && HASH_MATCH_MD5(entries[slot].hash, hash))
+                return entries[slot].id;
+        }
+
+        return -1;
+    }
+
+    // returns false if the hash was already in the index (or if it didn't fit)
+    inline bool32 Add(const uint32 *hash, int32 id, uint32 group = 0)
+    {
+        // cleared table entries never match anything
+        if (!(hash[0] | hash[1] | hash[2] | hash[3]))
+            return true;
+
+        uint32 slot = GetSlot(hash, group);
+        for (; entries[slot].generation == generation; slot = (slot + 1) & (size - 1)) {
+            if (entries[slot].group == group && HASH_MATCH_MD5(entries[slot].hash, hash)) {
+                if (id < entries[slot].id)
+                    entries[slot].id = id;
+                return false;
+            }
+        }
+
+        if (count >= size - (size >> 2)) {
+            full = true;
+            return false;
+        }
+
+        Entry *entry = &entries[slot];
+        HASH_COPY_MD5(entry->hash, hash);
+        entry->group      = group;
+        entry->id         = id;
+        entry->generation = generation;
+        ++count;
+        return true;
+    }
+
+    // MD5 output is already well distributed, no need to mix it any further
+    static inline uint32 GetSlot(const uint32 *hash, uint32 group) { return (hash[0] ^ (group * 0x9E3779B1)) & (size - 1); }
+};
+#endif
+
 inline void InitString(String *string, const char *text, uint32 textLength)
 {
     string->length = 0;